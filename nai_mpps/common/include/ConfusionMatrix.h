@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Dense K x K confusion counts for K classes identified by 0..K-1, with
+// rows indexed by the true class and columns by the predicted class.
+// Recording a sample is one increment regardless of K. The per-class
+// TP/FP/FN/TN, precision, recall and F1 as well as their macro and micro
+// averages are all derived from the matrix when asked for. Samples the
+// classifier gave no class are kept per true class: they are false
+// negatives of that class and misses overall, but nobody's false positive.
+class ConfusionMatrix
+{
+private:
+    size_t m_classes;
+    std::vector<uint64_t> m_counts;
+    std::vector<uint64_t> m_unpredicted;
+
+    uint64_t rowSum(size_t row) const
+    {
+        uint64_t sum = m_unpredicted[row];
+        for (size_t column = 0; column < m_classes; column++)
+        {
+            sum += m_counts[row * m_classes + column];
+        }
+
+        return sum;
+    };
+
+    uint64_t columnSum(size_t column) const
+    {
+        uint64_t sum = 0;
+        for (size_t row = 0; row < m_classes; row++)
+        {
+            sum += m_counts[row * m_classes + column];
+        }
+
+        return sum;
+    };
+
+    // NaN when the ratio is undefined, like an empty class's precision
+    static double ratio(uint64_t numerator, uint64_t denominator)
+    {
+        return denominator == 0 ? std::nan("") : (double)numerator / denominator;
+    };
+
+    static double harmonic(double p, double r)
+    {
+        return p + r == 0 ? std::nan("") : 2.0 * p * r / (p + r);
+    };
+
+    double macro(double (ConfusionMatrix::*measure)(size_t) const) const
+    {
+        double sum = 0.0;
+        size_t defined = 0;
+        for (size_t c = 0; c < m_classes; c++)
+        {
+            double value = (this->*measure)(c);
+            if (!std::isnan(value))
+            {
+                sum += value;
+                defined++;
+            }
+        }
+
+        return defined == 0 ? std::nan("") : sum / defined;
+    };
+
+public:
+    explicit ConfusionMatrix(size_t classes) : m_classes(classes), m_counts(classes * classes, 0), m_unpredicted(classes, 0){};
+
+    // Confusion over samples 0..count-1, where sample(i) returns the pair
+    // (true class, predicted class). With threads > 1 every worker classifies
+    // its own slice into a partial matrix and the partials are merged at the
+    // end, so sample has to be safe to call concurrently.
+    template <typename Sample>
+    static ConfusionMatrix evaluate(size_t count, size_t classes, size_t threads, Sample &&sample)
+    {
+        std::vector<ConfusionMatrix> partials(std::max<size_t>(threads, 1), ConfusionMatrix(classes));
+        auto work = [&](size_t t) {
+            const size_t begin = count * t / partials.size();
+            const size_t end = count * (t + 1) / partials.size();
+            for (size_t i = begin; i < end; i++)
+            {
+                auto [truth, prediction] = sample(i);
+                partials[t].add(truth, prediction);
+            }
+        };
+
+        std::vector<std::thread> workers{};
+        for (size_t t = 1; t < partials.size(); t++)
+        {
+            workers.emplace_back(work, t);
+        }
+
+        work(0);
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+
+        for (size_t t = 1; t < partials.size(); t++)
+        {
+            partials[0].merge(partials[t]);
+        }
+
+        return std::move(partials[0]);
+    };
+
+    // Confusion of predictions[i] against truth[i]
+    static ConfusionMatrix accumulate(const int *truth, const int *predictions, size_t count, size_t classes, size_t threads = 1)
+    {
+        return evaluate(count, classes, threads, [&](size_t i) {
+            return std::make_pair(truth[i], predictions[i]);
+        });
+    };
+
+    void add(size_t truth, size_t prediction)
+    {
+        if (truth >= m_classes || prediction >= m_classes)
+        {
+            throw std::out_of_range("Class " + std::to_string(std::max(truth, prediction)) + " is outside the confusion matrix");
+        }
+
+        m_counts[truth * m_classes + prediction]++;
+    };
+
+    // A sample of class truth that got no prediction
+    void addUnpredicted(size_t truth)
+    {
+        if (truth >= m_classes)
+        {
+            throw std::out_of_range("Class " + std::to_string(truth) + " is outside the confusion matrix");
+        }
+
+        m_unpredicted[truth]++;
+    };
+
+    void merge(const ConfusionMatrix &other)
+    {
+        if (other.m_classes != m_classes)
+        {
+            throw std::logic_error("Cannot merge confusion matrices of different sizes");
+        }
+
+        for (size_t i = 0; i < m_counts.size(); i++)
+        {
+            m_counts[i] += other.m_counts[i];
+        }
+
+        for (size_t c = 0; c < m_classes; c++)
+        {
+            m_unpredicted[c] += other.m_unpredicted[c];
+        }
+    };
+
+    size_t classes() const { return m_classes; };
+    uint64_t count(size_t truth, size_t prediction) const { return m_counts[truth * m_classes + prediction]; };
+
+    uint64_t unpredicted() const
+    {
+        uint64_t sum = 0;
+        for (uint64_t count : m_unpredicted)
+        {
+            sum += count;
+        }
+
+        return sum;
+    };
+
+    uint64_t total() const
+    {
+        uint64_t sum = unpredicted();
+        for (uint64_t count : m_counts)
+        {
+            sum += count;
+        }
+
+        return sum;
+    };
+
+    uint64_t correct() const
+    {
+        uint64_t sum = 0;
+        for (size_t c = 0; c < m_classes; c++)
+        {
+            sum += count(c, c);
+        }
+
+        return sum;
+    };
+
+    uint64_t truePositives(size_t c) const { return count(c, c); };
+    uint64_t falsePositives(size_t c) const { return columnSum(c) - count(c, c); };
+    uint64_t falseNegatives(size_t c) const { return rowSum(c) - count(c, c); };
+    uint64_t trueNegatives(size_t c) const { return total() - rowSum(c) - columnSum(c) + count(c, c); };
+
+    // Share of all samples predicted correctly
+    double accuracy() const { return ratio(correct(), total()); };
+    // One-vs-rest accuracy of class c: (TP + TN) / all
+    double accuracy(size_t c) const { return ratio(truePositives(c) + trueNegatives(c), total()); };
+    double precision(size_t c) const { return ratio(truePositives(c), columnSum(c)); };
+    double recall(size_t c) const { return ratio(truePositives(c), rowSum(c)); };
+    double f1(size_t c) const { return harmonic(precision(c), recall(c)); };
+
+    // Unweighted means over the classes, skipping classes where the measure is undefined
+    double macroPrecision() const { return macro(&ConfusionMatrix::precision); };
+    double macroRecall() const { return macro(&ConfusionMatrix::recall); };
+    double macroF1() const { return macro(&ConfusionMatrix::f1); };
+
+    // From the TP/FP/FN summed over the classes; with one label per sample
+    // they all equal the accuracy unless some samples got no prediction,
+    // which only count against recall
+    double microPrecision() const { return ratio(correct(), total() - unpredicted()); };
+    double microRecall() const { return accuracy(); };
+    double microF1() const { return harmonic(microPrecision(), microRecall()); };
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file mapped into memory. Empty files map to an
+// empty view, since neither mmap nor CreateFileMapping accept a zero length.
+class MappedFile
+{
+private:
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = NULL;
+#endif
+
+    void close()
+    {
+#ifdef _WIN32
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_mapping != NULL)
+        {
+            CloseHandle(m_mapping);
+        }
+
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+        }
+#else
+        if (m_data != nullptr)
+        {
+            munmap((void *)m_data, m_size);
+        }
+#endif
+    };
+
+public:
+    explicit MappedFile(const std::filesystem::path &path)
+    {
+#ifdef _WIN32
+        m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        LARGE_INTEGER size{};
+        if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size))
+        {
+            close();
+            throw std::runtime_error("Cannot open " + path.string());
+        }
+
+        m_size = (size_t)size.QuadPart;
+        if (m_size == 0)
+        {
+            return;
+        }
+
+        m_mapping = CreateFileMappingW(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        m_data = m_mapping == NULL ? nullptr : (const char *)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (m_data == nullptr)
+        {
+            close();
+            throw std::runtime_error("Cannot map " + path.string());
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat info{};
+        if (fd < 0 || fstat(fd, &info) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+
+            throw std::runtime_error("Cannot open " + path.string());
+        }
+
+        m_size = (size_t)info.st_size;
+        if (m_size > 0)
+        {
+            void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                m_data = (const char *)data;
+                madvise(data, m_size, MADV_SEQUENTIAL);
+            }
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+        if (m_size > 0 && m_data == nullptr)
+        {
+            throw std::runtime_error("Cannot map " + path.string());
+        }
+#endif
+    };
+
+    MappedFile() = delete;
+    MappedFile(const MappedFile &other) = delete;
+    MappedFile &operator=(const MappedFile &other) = delete;
+    MappedFile(MappedFile &&) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+    ~MappedFile() { close(); };
+
+    const char *data() const { return m_data; };
+    size_t size() const { return m_size; };
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** generator (Blackman & Vigna) shared by the mpp projects.
+// One instance per thread: stream(i) hands out generators whose sequences
+// are 2^128 draws apart, so workers never overlap and a run is reproduced
+// bit for bit from its seed. Satisfies UniformRandomBitGenerator, so it can
+// be passed to std::shuffle and the <random> distributions.
+class Random
+{
+private:
+    uint64_t m_state[4];
+
+    static uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    // splitmix64 spreads a single seed over the whole 256-bit state
+    static uint64_t splitmix(uint64_t &x)
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Random(uint64_t seed)
+    {
+        for (auto &s : m_state)
+        {
+            s = splitmix(seed);
+        }
+    };
+
+    static constexpr result_type min() { return 0; };
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); };
+
+    result_type operator()()
+    {
+        const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+
+        return result;
+    };
+
+    // Uniform in [0, 1) from the top 53 bits
+    double uniform()
+    {
+        return ((*this)() >> 11) * 0x1.0p-53;
+    };
+
+    double uniform(double from, double to)
+    {
+        return from + (to - from) * uniform();
+    };
+
+    // Uniform in [0, bound) without modulo bias (Lemire's multiply-shift on the top 32 bits)
+    uint32_t below(uint32_t bound)
+    {
+        uint64_t m = ((*this)() >> 32) * bound;
+        uint32_t low = (uint32_t)m;
+        if (low < bound)
+        {
+            const uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold)
+            {
+                m = ((*this)() >> 32) * bound;
+                low = (uint32_t)m;
+            }
+        }
+
+        return (uint32_t)(m >> 32);
+    };
+
+    // Advances the state by 2^128 draws
+    void jump()
+    {
+        static const uint64_t JUMP[] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+                                        0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+        uint64_t s[4] = {0, 0, 0, 0};
+        for (uint64_t jump : JUMP)
+        {
+            for (int b = 0; b < 64; ++b)
+            {
+                if (jump & (1ull << b))
+                {
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        s[i] ^= m_state[i];
+                    }
+                }
+
+                (*this)();
+            }
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            m_state[i] = s[i];
+        }
+    };
+
+    // Independent generator for worker `index`, derived from this one's state
+    Random stream(size_t index) const
+    {
+        Random result = *this;
+        for (size_t i = 0; i <= index; ++i)
+        {
+            result.jump();
+        }
+
+        return result;
+    };
+};
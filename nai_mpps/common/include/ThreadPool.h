@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads draining a FIFO of jobs. wait() blocks until
+// every job submitted so far has finished; the pool can be reused afterwards.
+class ThreadPool
+{
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_jobReady;
+    std::condition_variable m_idle;
+    size_t m_running = 0;
+    bool m_stopping = false;
+
+    void work()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobReady.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+                if (m_jobs.empty())
+                {
+                    return;
+                }
+
+                job = std::move(m_jobs.front());
+                m_jobs.pop();
+                m_running++;
+            }
+
+            job();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running--;
+            if (m_running == 0 && m_jobs.empty())
+            {
+                m_idle.notify_all();
+            }
+        }
+    };
+
+public:
+    // threads == 0 picks one worker per hardware thread
+    explicit ThreadPool(size_t threads = 0)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        for (size_t t = 0; t < threads; ++t)
+        {
+            m_workers.emplace_back(&ThreadPool::work, this);
+        }
+    };
+
+    ThreadPool(const ThreadPool &other) = delete;
+    ThreadPool &operator=(const ThreadPool &other) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+
+        m_jobReady.notify_all();
+        for (std::thread &worker : m_workers)
+        {
+            worker.join();
+        }
+    };
+
+    size_t size() const { return m_workers.size(); };
+
+    void submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push(std::move(job));
+        }
+
+        m_jobReady.notify_one();
+    };
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_running == 0 && m_jobs.empty(); });
+    };
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Utils.h"
+#include "Random.h"
 
 #include <string>
 #include <iostream>
@@ -21,7 +22,7 @@ private:
     std::string m_label;
 
 public:
-    Perceptron(float threshold, float learning_rate, size_t dimensions, std::string label);
+    Perceptron(float threshold, float learning_rate, size_t dimensions, std::string label, Random &random);
     std::string getLabel() const { return m_label; };
     int Perceptron::guess(const std::vector<float> &input) const;
     float Perceptron::raw(const std::vector<float> &input) const;
@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <queue>
 #include <stdexcept>
+#include <time.h>
 
 using Network = std::vector<Perceptron>;
 #define MAX_ITERATIONS 1000
@@ -67,7 +68,11 @@ int checkAccuracy(DecisionTable &testTable, Classifier &classifier, int &correct
 int main(int argc, char const *argv[])
 {
     setlocale(LC_ALL, "pl-PL");
-    srand(time(NULL));
+
+    // Optional third argument reproduces a previous run
+    uint64_t seed = argc > 3 ? std::stoull(argv[3]) : (uint64_t)time(NULL);
+    std::cout << "Seed: " << seed << std::endl;
+    Random random(seed);
 
     std::unordered_map<std::string, int> decision_map =
         {
@@ -98,9 +103,9 @@ int main(int argc, char const *argv[])
     }
 
     std::queue<Perceptron> perceptrons{};
-    perceptrons.push({1, 1.0f, train_table.columns(), "Iris-setosa"});
-    perceptrons.push({1, 0.1f, train_table.columns(), "Iris-versicolor"});
-    perceptrons.push({1, 0.1f, train_table.columns(), "Iris-virginica"});
+    perceptrons.push({1, 1.0f, train_table.columns(), "Iris-setosa", random});
+    perceptrons.push({1, 0.1f, train_table.columns(), "Iris-versicolor", random});
+    perceptrons.push({1, 0.1f, train_table.columns(), "Iris-virginica", random});
 
     Teacher teacher(train_table, test_table, MAX_ITERATIONS, MIN_ACCURACY, perceptrons);
     Network trained = teacher.trainAll();
@@ -1,12 +1,12 @@
 #include "Perceptron.h"
 
-Perceptron::Perceptron(float threshold, float learning_rate, size_t dimensions, std::string label)
+Perceptron::Perceptron(float threshold, float learning_rate, size_t dimensions, std::string label, Random &random)
     : m_threshold(threshold), m_learning_rate(learning_rate), m_dimensions(dimensions), m_label(label)
 {
     m_weights = {};
     for (size_t i = 0; i < m_dimensions; i++)
     {
-        m_weights.push_back(rand() % 100);
+        m_weights.push_back(random.below(100));
     }
 }
 
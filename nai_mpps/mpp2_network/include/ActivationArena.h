@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <span>
+
+// Two output buffers sized once for the widest layer; consecutive layers
+// alternate between them, so a forward pass writes into memory it owns
+// instead of growing fresh vectors per layer and sample
+class ActivationArena
+{
+private:
+    std::vector<double> m_buffers[2];
+    size_t m_current = 0;
+
+public:
+    explicit ActivationArena(size_t width);
+    ActivationArena() = delete;
+    ~ActivationArena() = default;
+    ActivationArena(const ActivationArena &other) = default;
+    ActivationArena &operator=(const ActivationArena &other) = default;
+    ActivationArena(ActivationArena &&) = default;
+    ActivationArena &operator=(ActivationArena &&) = default;
+
+    // Buffer for the next layer's outputs (never the one handed out just before)
+    std::span<double> next(size_t width);
+};
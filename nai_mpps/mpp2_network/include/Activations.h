@@ -0,0 +1,127 @@
+#pragma once
+
+#include <stdexcept>
+#include "DenseLayer.h"
+
+// In-place e^x over a contiguous range, SSE2/AVX2 when available.
+// Inputs are clamped to [-708, 709]; within that range the relative error is
+// below 1.1e-8 (degree 7 polynomial on |r| <= ln2/2, see Activations.cpp).
+void fastExp(double *values, size_t count);
+
+// Activation functors: each applies a whole layer's outputs in place and
+// turns dL/da into dL/dz given the activated outputs. DenseLayer picks one
+// per call through dispatchActivation, so there is no per-element dispatch.
+
+struct IdentityFunc
+{
+    static void apply(Eigen::Ref<Matrix> /*outputs*/){};
+    static void derivative(const Eigen::Ref<const Matrix> & /*outputs*/, Eigen::Ref<Matrix> /*delta*/){};
+};
+
+struct StepFunc
+{
+    static void apply(Eigen::Ref<Matrix> outputs)
+    {
+        outputs = (outputs.array() >= 0).cast<double>();
+    };
+
+    static void derivative(const Eigen::Ref<const Matrix> & /*outputs*/, Eigen::Ref<Matrix> /*delta*/)
+    {
+        throw std::logic_error("Step activation is not differentiable");
+    };
+};
+
+// 1 / (1 + e^-x), relative error below 1.1e-8
+struct SigmoidFunc
+{
+    static void apply(Eigen::Ref<Matrix> outputs)
+    {
+        for (Eigen::Index m = 0; m < outputs.rows(); ++m)
+        {
+            auto row = outputs.row(m).array();
+            row = -row;
+            fastExp(row.data(), row.size());
+            row = (1.0 + row).inverse();
+        }
+    };
+
+    static void derivative(const Eigen::Ref<const Matrix> &outputs, Eigen::Ref<Matrix> delta)
+    {
+        delta.array() *= outputs.array() * (1.0 - outputs.array());
+    };
+};
+
+// 1 - 2 / (e^2x + 1), absolute error below 1.1e-8
+struct TanhFunc
+{
+    static void apply(Eigen::Ref<Matrix> outputs)
+    {
+        for (Eigen::Index m = 0; m < outputs.rows(); ++m)
+        {
+            auto row = outputs.row(m).array();
+            row *= 2.0;
+            fastExp(row.data(), row.size());
+            row = 1.0 - 2.0 / (row + 1.0);
+        }
+    };
+
+    static void derivative(const Eigen::Ref<const Matrix> &outputs, Eigen::Ref<Matrix> delta)
+    {
+        delta.array() *= 1.0 - outputs.array().square();
+    };
+};
+
+struct ReLUFunc
+{
+    static void apply(Eigen::Ref<Matrix> outputs)
+    {
+        outputs = outputs.array().max(0.0);
+    };
+
+    static void derivative(const Eigen::Ref<const Matrix> &outputs, Eigen::Ref<Matrix> delta)
+    {
+        delta.array() *= (outputs.array() > 0).cast<double>();
+    };
+};
+
+// Row-wise e^(x - max) / sum, relative error below 2.2e-8
+struct SoftmaxFunc
+{
+    static void apply(Eigen::Ref<Matrix> outputs)
+    {
+        for (Eigen::Index m = 0; m < outputs.rows(); ++m)
+        {
+            auto row = outputs.row(m).array();
+            row -= row.maxCoeff();
+            fastExp(row.data(), row.size());
+            row /= row.sum();
+        }
+    };
+
+    static void derivative(const Eigen::Ref<const Matrix> & /*outputs*/, Eigen::Ref<Matrix> /*delta*/)
+    {
+        // Only trained through its cross-entropy shortcut (dL/dz = a - y)
+        throw std::logic_error("Softmax can only be the output layer of a cross-entropy network");
+    };
+};
+
+template <typename Visitor>
+void dispatchActivation(Activation activation, Visitor &&visitor)
+{
+    switch (activation)
+    {
+    case Activation::Step:
+        return visitor(StepFunc{});
+    case Activation::Sigmoid:
+        return visitor(SigmoidFunc{});
+    case Activation::Tanh:
+        return visitor(TanhFunc{});
+    case Activation::ReLU:
+        return visitor(ReLUFunc{});
+    case Activation::Softmax:
+        return visitor(SoftmaxFunc{});
+    case Activation::Identity:
+    default:
+        return visitor(IdentityFunc{});
+    }
+}
@@ -16,6 +16,7 @@ public:
     BiasNeuron(BiasNeuron &&) = default;
     BiasNeuron &operator=(BiasNeuron &&) = default;
 
-    void feedForward(const std::vector<double> &inputs) override;
+    double getConstant() const { return m_constant; };
+    void feedForward(std::span<const double> inputs) override;
     void backPropagate(int answer) override;
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <unordered_map>
@@ -10,14 +11,19 @@ class DecisionTable
 private:
     std::vector<int> m_decisions;
     std::vector<std::vector<double>> m_valueMatrix;
+    std::vector<double> m_packedMatrix;
     std::vector<std::pair<double, double>> m_min_max;
     std::unordered_map<std::string, int> m_decisionMap;
     int DecisionTable::set_min_max(std::vector<bool> &flags);
+    void pack();
 
 public:
     explicit DecisionTable(std::unordered_map<std::string, int> decisionMap) : m_decisionMap(decisionMap){};
     std::vector<std::vector<double>> &matrix() { return m_valueMatrix; };
     std::vector<int> &decision() { return m_decisions; };
+    const std::vector<int> &decision() const { return m_decisions; };
+    // Row-major rows() x columns() copy of matrix(), refreshed on load and normalization
+    const std::vector<double> &packedMatrix() const { return m_packedMatrix; };
     size_t rows() const { return m_valueMatrix.size(); };
     size_t columns() const;
     std::string toDecisionString(int value) const;
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include "Random.h"
+
+// Samples are stored as rows, so a whole batch is one contiguous block
+using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+using RowVector = Eigen::RowVectorXd;
+using MatrixView = Eigen::Map<Matrix, 0, Eigen::OuterStride<>>;
+using ConstMatrixView = Eigen::Map<const Matrix, 0, Eigen::OuterStride<>>;
+
+enum class Activation
+{
+    Identity,
+    Step,
+    Sigmoid,
+    Tanh,
+    ReLU,
+    Softmax
+};
+
+class DenseLayer
+{
+private:
+    Matrix m_weights; // inputs x outputs
+    RowVector m_bias;
+    Activation m_activation;
+
+public:
+    explicit DenseLayer(size_t inputs, size_t outputs, Activation activation, Random &random);
+    explicit DenseLayer(Matrix weights, RowVector bias, Activation activation);
+    DenseLayer() = delete;
+    ~DenseLayer() = default;
+    DenseLayer(const DenseLayer &other) = default;
+    DenseLayer &operator=(const DenseLayer &other) = default;
+    DenseLayer(DenseLayer &&) = default;
+    DenseLayer &operator=(DenseLayer &&) = default;
+
+    size_t inputs() const { return m_weights.rows(); };
+    size_t outputs() const { return m_weights.cols(); };
+    Matrix &weights() { return m_weights; };
+    const Matrix &weights() const { return m_weights; };
+    RowVector &bias() { return m_bias; };
+    const RowVector &bias() const { return m_bias; };
+    Activation activation() const { return m_activation; };
+
+    // outputs(N x outputs) = f(inputs(N x inputs) * W + b)
+    void feedForward(const Eigen::Ref<const Matrix> &inputs, Eigen::Ref<Matrix> outputs) const;
+
+    // Turns dL/da into dL/dz in place, using the activated outputs a
+    void activationDerivative(const Eigen::Ref<const Matrix> &outputs, Eigen::Ref<Matrix> delta) const;
+
+    // Given dL/dz of this layer, writes the weight/bias gradients and,
+    // unless previousDelta is empty, dL/da of the previous layer
+    void backPropagate(const Eigen::Ref<const Matrix> &inputs,
+                       const Eigen::Ref<const Matrix> &delta,
+                       Eigen::Ref<Matrix> weightGradient,
+                       Eigen::Ref<RowVector> biasGradient,
+                       Eigen::Ref<Matrix> previousDelta) const;
+};
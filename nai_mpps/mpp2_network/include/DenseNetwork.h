@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include "DenseLayer.h"
+#include "Network.h"
+#include "DecisionTable.h"
+
+// Rows processed per matrix product in batched inference
+#define BLOCK_ROWS 256
+
+// N x d view of a loaded table, suitable for DenseNetwork::predict
+inline Eigen::Map<const Matrix> asMatrix(const DecisionTable &table)
+{
+    const std::vector<double> &packed = table.packedMatrix();
+    return Eigen::Map<const Matrix>(packed.data(), table.rows(), table.rows() == 0 ? 0 : packed.size() / table.rows());
+}
+
+class DenseNetwork
+{
+private:
+    std::vector<DenseLayer> m_layers;
+    std::vector<Matrix> m_outputs;
+    bool m_argmaxOutput = false;
+
+public:
+    // Collapses a neuron topology (see constructTopology) into dense layers:
+    // bias neurons are folded into the bias vectors, perceptrons into weight matrices
+    explicit DenseNetwork(const std::vector<Layer> &topology);
+    // Fresh classifier: sizes = {inputs, hidden..., classes}, one activation per weight layer
+    explicit DenseNetwork(const std::vector<size_t> &sizes, const std::vector<Activation> &activations, Random &random);
+    DenseNetwork() = delete;
+    DenseNetwork(const DenseNetwork &other) = delete;
+    DenseNetwork &operator=(const DenseNetwork &other) = delete;
+    DenseNetwork(DenseNetwork &&) = delete;
+    DenseNetwork &operator=(DenseNetwork &&) = delete;
+    ~DenseNetwork() = default;
+
+    std::vector<DenseLayer> &getLayers() { return m_layers; };
+    const std::vector<DenseLayer> &getLayers() const { return m_layers; };
+    void feedForward(const std::vector<double> &inputs);
+    double getResult();
+
+    // outputs(N x classes) for all N input rows, evaluated BLOCK_ROWS rows at a time;
+    // with threads > 1 the row blocks are split between that many workers
+    void predict(const Eigen::Ref<const Matrix> &inputs, Eigen::Ref<Matrix> outputs, size_t threads = 1) const;
+    // Index of the strongest output for every input row
+    std::vector<int> classify(const Eigen::Ref<const Matrix> &inputs, size_t threads = 1) const;
+};
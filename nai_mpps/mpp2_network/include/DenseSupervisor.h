@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "DenseNetwork.h"
+#include "Optimizer.h"
+#include "DecisionTable.h"
+
+// Rows a synchronous worker gets per step at least; a smaller shard does not
+// pay for the barrier rounds, so fewer workers are used instead
+#define MIN_SHARD_ROWS 32
+
+enum class ParallelMode
+{
+    // The rows of every step are split between the workers, their gradients are
+    // summed by a tree reduction and one optimizer step is taken: same result as
+    // one thread up to summation order, reproducible for a given seed and thread
+    // count. Only steps of at least MIN_SHARD_ROWS rows per worker scale, so
+    // small batches should be accumulated with syncBatches.
+    Synchronous,
+    // Workers train on their own shards and apply plain SGD updates
+    // (learningRate only; optimizer and momentum are not used) to the shared
+    // weights without locks, skipping zero gradient entries (sparse updates).
+    // Every batch is computed on a private snapshot of the weights read with
+    // relaxed atomic loads, so reads and the atomic adds of other workers
+    // never race; the snapshot may just be a few updates behind.
+    Hogwild
+};
+
+struct TrainingOptions
+{
+    uint32_t epochs = 200;
+    size_t batchSize = 16;
+    OptimizerType optimizer = OptimizerType::Adam;
+    double learningRate = 0.01;
+    double momentum = 0.9;
+    // Synchronous mode: batches whose gradients are accumulated into one
+    // optimizer step, so a step averages batchSize * syncBatches rows
+    size_t syncBatches = 1;
+    // Upper bound; never more workers than rows per step (see MIN_SHARD_ROWS)
+    size_t threads = 1;
+    ParallelMode mode = ParallelMode::Synchronous;
+    uint64_t seed = 0;
+};
+
+// Mini-batch gradient descent on the cross-entropy loss of a DenseNetwork.
+// The output layer has to be Softmax (categorical) or Sigmoid (one-vs-rest).
+class DenseSupervisor
+{
+private:
+    TrainingOptions m_options;
+    DecisionTable m_trainSet;
+    DecisionTable m_testSet;
+    DenseNetwork &m_network;
+    Optimizer m_optimizer;
+    Random m_random;
+    double m_loss = 0;
+
+    // Per-worker batch buffers sized once, so a training step does not allocate
+    struct Workspace
+    {
+        // Hogwild: the weights this worker's current batch is computed on
+        std::vector<DenseLayer> Snapshot;
+        Matrix Inputs;
+        Matrix Targets;
+        std::vector<Matrix> Activations;
+        std::vector<Matrix> Deltas;
+        std::vector<Matrix> WeightGradients;
+        std::vector<RowVector> BiasGradients;
+        double Loss = 0;
+    };
+
+    std::vector<size_t> m_order;
+    std::vector<Workspace> m_workspaces;
+    Matrix m_noDelta;
+
+    // Gradients of the layers for the rows m_order[first, first + count) into
+    // the workspace, divided by batchRows (the rows of the whole step)
+    void computeGradients(Workspace &workspace, const std::vector<DenseLayer> &layers, size_t first, size_t count, size_t batchRows);
+    void trainSynchronous();
+    void trainHogwild();
+
+public:
+    explicit DenseSupervisor(TrainingOptions options,
+                             DecisionTable trainData,
+                             DecisionTable testData,
+                             DenseNetwork &network);
+    DenseSupervisor() = delete;
+    DenseSupervisor(const DenseSupervisor &other) = delete;
+    DenseSupervisor &operator=(const DenseSupervisor &other) = delete;
+    DenseSupervisor(DenseSupervisor &&) = delete;
+    DenseSupervisor &operator=(DenseSupervisor &&) = delete;
+
+    void train();
+    double getAccuracy();
+    double getLoss() const { return m_loss; };
+};
@@ -1,9 +1,7 @@
 #pragma once
 
 #include <vector>
-#include <functional>
-
-using ActivationFunc = std::function<double(std::vector<double>)>;
+#include <span>
 
 class INeuron
 {
@@ -23,6 +21,6 @@ public:
         return m_output;
     };
 
-    virtual void feedForward(const std::vector<double> &inputs) = 0;
+    virtual void feedForward(std::span<const double> inputs) = 0;
     virtual void backPropagate(int answer) = 0;
 };
\ No newline at end of file
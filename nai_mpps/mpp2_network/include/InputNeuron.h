@@ -16,6 +16,6 @@ public:
     InputNeuron(InputNeuron &&) = default;
     InputNeuron &operator=(InputNeuron &&) = default;
 
-    void feedForward(const std::vector<double> &inputs) override;
+    void feedForward(std::span<const double> inputs) override;
     void backPropagate(int answer) override;
 };
\ No newline at end of file
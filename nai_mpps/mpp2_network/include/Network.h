@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include "INeuron.h"
+#include "ActivationArena.h"
 
 using Layer = std::vector<std::shared_ptr<INeuron>>;
 
@@ -10,6 +11,7 @@ class Network
 {
 private:
     std::vector<Layer> m_layers;
+    ActivationArena m_arena;
 public:
     Network(std::vector<Layer> &topology);
     Network() = delete;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include "DenseLayer.h"
+
+enum class OptimizerType
+{
+    Momentum,
+    Adam
+};
+
+class Optimizer
+{
+private:
+    OptimizerType m_type;
+    double m_learningRate;
+    double m_momentum;
+    double m_beta1 = 0.9;
+    double m_beta2 = 0.999;
+    double m_epsilon = 1e-8;
+    uint64_t m_steps = 0;
+
+    // First moments (velocity for momentum SGD) and Adam's second moments, one per layer
+    std::vector<Matrix> m_weightMoments;
+    std::vector<RowVector> m_biasMoments;
+    std::vector<Matrix> m_weightVariances;
+    std::vector<RowVector> m_biasVariances;
+
+public:
+    explicit Optimizer(OptimizerType type,
+                       double learningRate,
+                       double momentum,
+                       const std::vector<DenseLayer> &layers);
+    Optimizer() = delete;
+    ~Optimizer() = default;
+    Optimizer(const Optimizer &other) = default;
+    Optimizer &operator=(const Optimizer &other) = default;
+    Optimizer(Optimizer &&) = default;
+    Optimizer &operator=(Optimizer &&) = default;
+
+    void step(std::vector<DenseLayer> &layers,
+              const std::vector<Matrix> &weightGradients,
+              const std::vector<RowVector> &biasGradients);
+};
@@ -13,6 +13,6 @@ public:
     OutputNeuron(OutputNeuron &&) = default;
     OutputNeuron &operator=(OutputNeuron &&) = default;
 
-    void feedForward(const std::vector<double> &inputs) override;
+    void feedForward(std::span<const double> inputs) override;
     void backPropagate(int answer) override;
 };
\ No newline at end of file
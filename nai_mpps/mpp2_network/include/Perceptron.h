@@ -3,11 +3,13 @@
 #include <string>
 #include "INeuron.h"
 #include "Network.h"
+#include "Random.h"
 
 class Perceptron : public INeuron
 {
 private:
     std::vector<double> m_weights;
+    std::vector<double> m_inputs;
     int m_label;
     size_t m_dimensions;
     double m_threshold;
@@ -20,14 +22,16 @@ public:
                         size_t dimensions,
                         double threshold,
                         double learning_rate,
-                        Layer &prevLayer);
+                        Layer &prevLayer,
+                        Random &random);
     ~Perceptron() = default;
     Perceptron(const Perceptron &other) = default;
     Perceptron &operator=(const Perceptron &other) = default;
     Perceptron(Perceptron &&) = default;
     Perceptron &operator=(Perceptron &&) = default;
 
-    void feedForward(const std::vector<double> &inputs) override;
+    const std::vector<double> &getWeights() const { return m_weights; };
+    void feedForward(std::span<const double> inputs) override;
     void backPropagate(int answer) override;
     friend std::ostream &operator<<(std::ostream &os, const class Perceptron &dt);
 };
\ No newline at end of file
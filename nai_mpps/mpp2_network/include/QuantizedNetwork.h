@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "DenseNetwork.h"
+#include "DecisionTable.h"
+
+// Post-training int8 quantization of a DenseNetwork. Every layer keeps its
+// weights as int8 with one symmetric scale, inputs are quantized with a
+// per-layer scale taken from the largest magnitude seen on calibration rows.
+// Products are accumulated in int32 and dequantized before bias + activation.
+class QuantizedNetwork
+{
+private:
+    struct QuantizedLayer
+    {
+        std::vector<int8_t> Weights; // outputs x Stride, transposed and zero padded
+        size_t Inputs;
+        size_t Outputs;
+        size_t Stride;
+        double WeightScale;
+        double InputScale;
+        RowVector Bias;
+        Activation Function;
+    };
+
+    std::vector<QuantizedLayer> m_layers;
+
+public:
+    explicit QuantizedNetwork(const DenseNetwork &network, const DecisionTable &calibration);
+    QuantizedNetwork() = delete;
+    QuantizedNetwork(const QuantizedNetwork &other) = default;
+    QuantizedNetwork &operator=(const QuantizedNetwork &other) = default;
+    QuantizedNetwork(QuantizedNetwork &&) = default;
+    QuantizedNetwork &operator=(QuantizedNetwork &&) = default;
+    ~QuantizedNetwork() = default;
+
+    // outputs(N x classes), evaluated BLOCK_ROWS rows at a time
+    void predict(const Eigen::Ref<const Matrix> &inputs, Eigen::Ref<Matrix> outputs) const;
+    std::vector<int> classify(const Eigen::Ref<const Matrix> &inputs) const;
+    size_t sizeInBytes() const;
+};
+
+// Prints accuracy of the float and int8 models on the table, how often they agree and their sizes
+void printQuantizationReport(const DenseNetwork &network, const QuantizedNetwork &quantized, const DecisionTable &table);
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+#include "Network.h"
+#include "BiasNeuron.h"
+#include "Perceptron.h"
+#include "Utils.h"
+
+// Fixed-shape counterpart of the Iris Network: Inputs input neurons + bias ->
+// Perceptrons perceptrons -> argmax output neuron. All dimensions are template
+// parameters, weights live in std::array and every loop is unrolled through
+// index sequences, so a network built from literal weights evaluates in constexpr.
+template <size_t Inputs, size_t Perceptrons, size_t Outputs>
+class StaticNetwork
+{
+    static_assert(Inputs > 0 && Perceptrons > 0, "StaticNetwork needs at least one input and one perceptron");
+    static_assert(Outputs == 1, "StaticNetwork mirrors OutputNeuron: exactly one argmax output");
+
+public:
+    // One row per perceptron: input weights followed by the bias neuron's weight,
+    // the same order as Perceptron::getWeights
+    using Weights = std::array<std::array<double, Inputs + 1>, Perceptrons>;
+    using Sample = std::array<double, Inputs>;
+
+private:
+    Weights m_weights{};
+    double m_bias = 1.0;
+
+    // Accumulates in float exactly like dot() in Utils.h, so results
+    // (and argmax ties) match the dynamic Network bit for bit
+    template <size_t... I>
+    constexpr double net(const std::array<double, Inputs + 1> &w, const Sample &x, std::index_sequence<I...>) const
+    {
+        float result = 0;
+        ((result += w[I] * x[I]), ...);
+        result += w[Inputs] * m_bias;
+        return result;
+    }
+
+    template <size_t... P>
+    constexpr std::array<double, Perceptrons> layer(const Sample &x, std::index_sequence<P...>) const
+    {
+        return {net(m_weights[P], x, std::make_index_sequence<Inputs>{})...};
+    }
+
+public:
+    constexpr StaticNetwork() = default;
+    constexpr explicit StaticNetwork(const Weights &weights, double bias = 1.0) : m_weights(weights), m_bias(bias){};
+
+    // Copies the weights of a trained dynamic network built by constructTopology
+    static StaticNetwork fromTopology(const std::vector<Layer> &topology)
+    {
+        if (topology.size() != 3 || topology[0].size() != Inputs + 1 || topology[1].size() != Perceptrons)
+        {
+            throw std::logic_error(format(
+                "Topology does not have the %d+1 -> %d -> 1 shape",
+                Inputs,
+                Perceptrons));
+        }
+
+        auto bias = dynamic_cast<BiasNeuron *>(topology[0][Inputs].get());
+        if (bias == nullptr)
+        {
+            throw std::logic_error("Last neuron of the input layer has to be a bias neuron");
+        }
+
+        Weights weights{};
+        for (size_t p = 0; p < Perceptrons; ++p)
+        {
+            auto perceptron = dynamic_cast<Perceptron *>(topology[1][p].get());
+            if (perceptron == nullptr || perceptron->getWeights().size() != Inputs + 1)
+            {
+                throw std::logic_error(format("Neuron %d of the hidden layer is not a matching perceptron", p));
+            }
+
+            std::copy(perceptron->getWeights().begin(), perceptron->getWeights().end(), weights[p].begin());
+        }
+
+        return StaticNetwork(weights, bias->getConstant());
+    }
+
+    constexpr const Weights &getWeights() const { return m_weights; };
+
+    constexpr std::array<double, Perceptrons> feedForward(const Sample &inputs) const
+    {
+        return layer(inputs, std::make_index_sequence<Perceptrons>{});
+    }
+
+    // Index of the first strongest perceptron, like OutputNeuron
+    constexpr double getResult(const Sample &inputs) const
+    {
+        std::array<double, Perceptrons> outputs = feedForward(inputs);
+        size_t best = 0;
+        for (size_t p = 1; p < Perceptrons; ++p)
+        {
+            if (outputs[p] > outputs[best])
+            {
+                best = p;
+            }
+        }
+
+        return best;
+    }
+};
+
+// Keeps the constexpr guarantee: the second perceptron only sees the second input
+static_assert(StaticNetwork<2, 2, 1>({{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}}}).getResult({0.5, 2.0}) == 1 &&
+                  StaticNetwork<2, 2, 1>({{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}}}).getResult({3.0, 1.0}) == 0,
+              "StaticNetwork::getResult has to evaluate in constexpr");
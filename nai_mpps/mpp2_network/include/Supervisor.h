@@ -5,6 +5,7 @@
 
 #include "Perceptron.h"
 #include "Network.h"
+#include "DenseNetwork.h"
 #include "DecisionTable.h"
 
 class Supervisor
@@ -28,4 +29,5 @@ public:
 
     void train();
     double getAccuracy();
+    double getAccuracy(DenseNetwork &network);
 };
\ No newline at end of file
@@ -8,8 +8,9 @@
 #include <unordered_map>
 #include <queue>
 #include <stdexcept>
+#include <span>
 
-static float dot(const std::vector<double> &v1, const std::vector<double> &v2)
+static float dot(std::span<const double> v1, std::span<const double> v2)
 {
     if (v1.size() != v2.size())
     {
@@ -0,0 +1,16 @@
+#include "assert.h"
+#include "ActivationArena.h"
+
+ActivationArena::ActivationArena(size_t width)
+{
+    m_buffers[0].resize(width);
+    m_buffers[1].resize(width);
+};
+
+std::span<double> ActivationArena::next(size_t width)
+{
+    assert(width <= m_buffers[0].size());
+
+    m_current ^= 1;
+    return std::span<double>(m_buffers[m_current].data(), width);
+};
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include "Activations.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// e^x = 2^n * e^r with n = round(x / ln2) and |r| <= ln2/2. e^r comes from its
+// degree 7 Taylor polynomial, whose remainder bounds the relative error by
+// e^(2|r|) * |r|^8 / 8! < 1.1e-8. n is recovered without a float->int64
+// conversion in the SIMD paths: adding 1.5 * 2^52 rounds x / ln2 into the
+// low mantissa bits.
+static const double EXP_MIN = -708.0;
+static const double EXP_MAX = 709.0;
+static const double LOG2E = 1.4426950408889634;
+static const double LN2_HI = 6.93145751953125e-1;
+static const double LN2_LO = 1.42860682030941723212e-6;
+static const double ROUND_MAGIC = 6755399441055744.0;
+static const double C2 = 1.0 / 2;
+static const double C3 = 1.0 / 6;
+static const double C4 = 1.0 / 24;
+static const double C5 = 1.0 / 120;
+static const double C6 = 1.0 / 720;
+static const double C7 = 1.0 / 5040;
+
+static double fastExp(double x)
+{
+    x = std::min(std::max(x, EXP_MIN), EXP_MAX);
+    double n = std::nearbyint(x * LOG2E);
+    double r = x - n * LN2_HI - n * LN2_LO;
+    double p = 1.0 + r * (1.0 + r * (C2 + r * (C3 + r * (C4 + r * (C5 + r * (C6 + r * C7))))));
+
+    // The scalar tail may run on x87, whose excess precision defeats the rounding trick
+    int64_t scaleBits = ((int64_t)n + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &scaleBits, sizeof(scale));
+    return p * scale;
+}
+
+#if defined(__AVX2__)
+static __m256d fastExp(__m256d x)
+{
+    x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(EXP_MIN)), _mm256_set1_pd(EXP_MAX));
+    const __m256d magic = _mm256_set1_pd(ROUND_MAGIC);
+    __m256d t = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(LOG2E)), magic);
+    __m256d n = _mm256_sub_pd(t, magic);
+    __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(LN2_HI))),
+                              _mm256_mul_pd(n, _mm256_set1_pd(LN2_LO)));
+
+    __m256d p = _mm256_set1_pd(C7);
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(C6));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(C5));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(C4));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(C3));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(C2));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0));
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0));
+
+    __m256i bits = _mm256_sub_epi64(_mm256_castpd_si256(t), _mm256_castpd_si256(magic));
+    bits = _mm256_slli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52);
+    return _mm256_mul_pd(p, _mm256_castsi256_pd(bits));
+}
+#elif defined(_M_X64) || defined(__SSE2__)
+static __m128d fastExp(__m128d x)
+{
+    x = _mm_min_pd(_mm_max_pd(x, _mm_set1_pd(EXP_MIN)), _mm_set1_pd(EXP_MAX));
+    const __m128d magic = _mm_set1_pd(ROUND_MAGIC);
+    __m128d t = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(LOG2E)), magic);
+    __m128d n = _mm_sub_pd(t, magic);
+    __m128d r = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(n, _mm_set1_pd(LN2_HI))),
+                           _mm_mul_pd(n, _mm_set1_pd(LN2_LO)));
+
+    __m128d p = _mm_set1_pd(C7);
+    p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(C6));
+    p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(C5));
+    p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(C4));
+    p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(C3));
+    p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(C2));
+    p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(1.0));
+    p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(1.0));
+
+    __m128i bits = _mm_sub_epi64(_mm_castpd_si128(t), _mm_castpd_si128(magic));
+    bits = _mm_slli_epi64(_mm_add_epi64(bits, _mm_set1_epi64x(1023)), 52);
+    return _mm_mul_pd(p, _mm_castsi128_pd(bits));
+}
+#endif
+
+void fastExp(double *values, size_t count)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm256_storeu_pd(values + i, fastExp(_mm256_loadu_pd(values + i)));
+    }
+#elif defined(_M_X64) || defined(__SSE2__)
+    for (; i + 2 <= count; i += 2)
+    {
+        _mm_storeu_pd(values + i, fastExp(_mm_loadu_pd(values + i)));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        values[i] = fastExp(values[i]);
+    }
+}
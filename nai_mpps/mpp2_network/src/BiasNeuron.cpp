@@ -2,7 +2,7 @@
 
 BiasNeuron::BiasNeuron(double constant) : m_constant(constant){};
 
-void BiasNeuron::feedForward(const std::vector<double> &inputs)
+void BiasNeuron::feedForward(std::span<const double> inputs)
 {
     m_output = m_constant;
 };
@@ -104,6 +104,7 @@ int DecisionTable::normalize(std::vector<bool> &flags)
         }
     }
 
+    pack();
     return 0;
 };
 
@@ -132,6 +133,16 @@ int DecisionTable::normalize(std::vector<double> &c) const
     return 0;
 };
 
+void DecisionTable::pack()
+{
+    m_packedMatrix.clear();
+    m_packedMatrix.reserve(m_valueMatrix.empty() ? 0 : rows() * columns());
+    for (const auto &row : m_valueMatrix)
+    {
+        m_packedMatrix.insert(m_packedMatrix.end(), row.begin(), row.end());
+    }
+};
+
 DecisionTable &DecisionTable::operator=(const DecisionTable &dt)
 {
     if (this == &dt)
@@ -140,6 +151,7 @@ DecisionTable &DecisionTable::operator=(const DecisionTable &dt)
     }
 
     this->m_valueMatrix = dt.m_valueMatrix;
+    this->m_packedMatrix = dt.m_packedMatrix;
     return *this;
 };
 
@@ -189,6 +201,8 @@ const std::ifstream &operator>>(std::ifstream &ofs, DecisionTable &dt)
         line_number++;
     }
 
+    dt.pack();
+
     // std::sort(dt.m_valueMatrix.begin(), dt.m_valueMatrix.end());
     // auto last = std::unique(dt.m_valueMatrix.begin(), dt.m_valueMatrix.end());
     // if (last != dt.m_valueMatrix.end())
@@ -0,0 +1,55 @@
+#include <cmath>
+#include "assert.h"
+#include "DenseLayer.h"
+#include "Activations.h"
+
+DenseLayer::DenseLayer(size_t inputs, size_t outputs, Activation activation, Random &random)
+    : m_weights(inputs, outputs), m_bias(RowVector::Zero(outputs)), m_activation(activation)
+{
+    // Glorot/Xavier uniform initialization keeps the activations' variance stable across layers
+    double limit = std::sqrt(6.0 / (inputs + outputs));
+    for (Eigen::Index i = 0; i < m_weights.size(); ++i)
+    {
+        m_weights.data()[i] = random.uniform(-limit, limit);
+    }
+};
+
+DenseLayer::DenseLayer(Matrix weights, RowVector bias, Activation activation)
+    : m_weights(std::move(weights)), m_bias(std::move(bias)), m_activation(activation)
+{
+    assert(m_weights.cols() == m_bias.size());
+};
+
+void DenseLayer::feedForward(const Eigen::Ref<const Matrix> &inputs, Eigen::Ref<Matrix> outputs) const
+{
+    assert(inputs.cols() == m_weights.rows());
+    assert(outputs.rows() == inputs.rows() && outputs.cols() == m_weights.cols());
+
+    outputs.noalias() = inputs * m_weights;
+    outputs.rowwise() += m_bias;
+
+    dispatchActivation(m_activation, [&](auto func) {
+        decltype(func)::apply(outputs);
+    });
+};
+
+void DenseLayer::activationDerivative(const Eigen::Ref<const Matrix> &outputs, Eigen::Ref<Matrix> delta) const
+{
+    dispatchActivation(m_activation, [&](auto func) {
+        decltype(func)::derivative(outputs, delta);
+    });
+};
+
+void DenseLayer::backPropagate(const Eigen::Ref<const Matrix> &inputs,
+                               const Eigen::Ref<const Matrix> &delta,
+                               Eigen::Ref<Matrix> weightGradient,
+                               Eigen::Ref<RowVector> biasGradient,
+                               Eigen::Ref<Matrix> previousDelta) const
+{
+    weightGradient.noalias() = inputs.transpose() * delta;
+    biasGradient.noalias() = delta.colwise().sum();
+    if (previousDelta.size() != 0)
+    {
+        previousDelta.noalias() = delta * m_weights.transpose();
+    }
+};
@@ -0,0 +1,226 @@
+#include <thread>
+#include "assert.h"
+#include "DenseNetwork.h"
+#include "InputNeuron.h"
+#include "BiasNeuron.h"
+#include "Perceptron.h"
+#include "OutputNeuron.h"
+#include "Utils.h"
+
+DenseNetwork::DenseNetwork(const std::vector<Layer> &topology)
+{
+    assert(topology.empty() == false);
+
+    // For every neuron of the previous layer: its column in the dense output
+    // (-1 for bias neurons) and the constant it contributes to the next bias
+    std::vector<long> previousColumns{};
+    std::vector<double> previousConstants{};
+    size_t previousWidth = 0;
+    for (const auto &neuron : topology[0])
+    {
+        if (auto bias = dynamic_cast<BiasNeuron *>(neuron.get()))
+        {
+            previousColumns.push_back(-1);
+            previousConstants.push_back(bias->getConstant());
+            continue;
+        }
+
+        if (dynamic_cast<InputNeuron *>(neuron.get()) == nullptr)
+        {
+            throw std::logic_error("Input layer may consist only of input and bias neurons");
+        }
+
+        previousColumns.push_back(previousWidth++);
+        previousConstants.push_back(0);
+    }
+
+    for (size_t layerNum = 1; layerNum < topology.size(); ++layerNum)
+    {
+        const Layer &layer = topology[layerNum];
+        if (layerNum == topology.size() - 1 &&
+            layer.size() == 1 &&
+            dynamic_cast<OutputNeuron *>(layer[0].get()) != nullptr)
+        {
+            m_argmaxOutput = true;
+            break;
+        }
+
+        size_t width = std::count_if(layer.begin(), layer.end(), [](auto &neuron) {
+            return dynamic_cast<Perceptron *>(neuron.get()) != nullptr;
+        });
+
+        Matrix weights = Matrix::Zero(previousWidth, width);
+        RowVector bias = RowVector::Zero(width);
+        std::vector<long> columns{};
+        std::vector<double> constants{};
+        long column = 0;
+        for (const auto &neuron : layer)
+        {
+            if (auto biasNeuron = dynamic_cast<BiasNeuron *>(neuron.get()))
+            {
+                columns.push_back(-1);
+                constants.push_back(biasNeuron->getConstant());
+                continue;
+            }
+
+            auto perceptron = dynamic_cast<Perceptron *>(neuron.get());
+            if (perceptron == nullptr)
+            {
+                throw std::logic_error(format(
+                    "Unsupported neuron in layer %d (only perceptrons and bias neurons can be densified)",
+                    layerNum));
+            }
+
+            const std::vector<double> &w = perceptron->getWeights();
+            if (w.size() != previousColumns.size())
+            {
+                throw std::logic_error(format(
+                    "Perceptron in layer %d has %d weights for %d inputs",
+                    layerNum,
+                    w.size(),
+                    previousColumns.size()));
+            }
+
+            for (size_t i = 0; i < w.size(); ++i)
+            {
+                if (previousColumns[i] < 0)
+                {
+                    bias[column] += w[i] * previousConstants[i];
+                    continue;
+                }
+
+                weights(previousColumns[i], column) = w[i];
+            }
+
+            columns.push_back(column++);
+            constants.push_back(0);
+        }
+
+        m_layers.emplace_back(std::move(weights), std::move(bias), Activation::Identity);
+        previousColumns = columns;
+        previousConstants = constants;
+        previousWidth = width;
+    }
+
+    if (m_layers.empty())
+    {
+        throw std::logic_error("Topology has no perceptron layers");
+    }
+
+    for (const auto &layer : m_layers)
+    {
+        m_outputs.push_back(Matrix::Zero(1, layer.outputs()));
+    }
+}
+
+DenseNetwork::DenseNetwork(const std::vector<size_t> &sizes, const std::vector<Activation> &activations, Random &random)
+    : m_argmaxOutput(true)
+{
+    if (sizes.size() < 2 || activations.size() != sizes.size() - 1)
+    {
+        throw std::logic_error(format(
+            "%d layer sizes need %d activations, got %d",
+            sizes.size(),
+            sizes.size() - 1,
+            activations.size()));
+    }
+
+    for (size_t l = 0; l < activations.size(); ++l)
+    {
+        m_layers.emplace_back(sizes[l], sizes[l + 1], activations[l], random);
+        m_outputs.push_back(Matrix::Zero(1, sizes[l + 1]));
+    }
+}
+
+void DenseNetwork::feedForward(const std::vector<double> &inputs)
+{
+    Eigen::Map<const Matrix> input(inputs.data(), 1, inputs.size());
+    m_layers[0].feedForward(input, m_outputs[0]);
+    for (size_t layerNum = 1; layerNum < m_layers.size(); ++layerNum)
+    {
+        m_layers[layerNum].feedForward(m_outputs[layerNum - 1], m_outputs[layerNum]);
+    }
+}
+
+double DenseNetwork::getResult()
+{
+    const Matrix &last = m_outputs.back();
+    if (m_argmaxOutput)
+    {
+        Eigen::Index index;
+        last.row(0).maxCoeff(&index);
+        return index;
+    }
+
+    return last(0, last.cols() - 1);
+}
+
+void DenseNetwork::predict(const Eigen::Ref<const Matrix> &inputs, Eigen::Ref<Matrix> outputs, size_t threads) const
+{
+    assert((size_t)inputs.cols() == m_layers.front().inputs());
+    assert(outputs.rows() == inputs.rows() && (size_t)outputs.cols() == m_layers.back().outputs());
+
+    size_t width = 0;
+    for (const auto &layer : m_layers)
+    {
+        width = std::max(width, layer.outputs());
+    }
+
+    const size_t rows = inputs.rows();
+    const size_t blocks = (rows + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    auto worker = [&](size_t firstBlock, size_t lastBlock) {
+        // Hidden layers ping-pong between two block-sized scratch matrices,
+        // the last layer writes straight into the caller's output rows
+        Matrix scratch[2] = {Matrix(BLOCK_ROWS, width), Matrix(BLOCK_ROWS, width)};
+        for (size_t block = firstBlock; block < lastBlock; ++block)
+        {
+            const size_t first = block * BLOCK_ROWS;
+            const size_t count = std::min<size_t>(BLOCK_ROWS, rows - first);
+            for (size_t l = 0; l < m_layers.size(); ++l)
+            {
+                const DenseLayer &layer = m_layers[l];
+                ConstMatrixView input = l == 0
+                                            ? ConstMatrixView(inputs.row(first).data(), count, layer.inputs(), Eigen::OuterStride<>(inputs.outerStride()))
+                                            : ConstMatrixView(scratch[(l - 1) % 2].data(), count, layer.inputs(), Eigen::OuterStride<>(width));
+                MatrixView current = l == m_layers.size() - 1
+                                         ? MatrixView(outputs.row(first).data(), count, layer.outputs(), Eigen::OuterStride<>(outputs.outerStride()))
+                                         : MatrixView(scratch[l % 2].data(), count, layer.outputs(), Eigen::OuterStride<>(width));
+                layer.feedForward(input, current);
+            }
+        }
+    };
+
+    threads = std::max<size_t>(1, std::min(threads, blocks));
+    if (threads == 1)
+    {
+        worker(0, blocks);
+        return;
+    }
+
+    std::vector<std::thread> workers{};
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(worker, blocks * t / threads, blocks * (t + 1) / threads);
+    }
+
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+}
+
+std::vector<int> DenseNetwork::classify(const Eigen::Ref<const Matrix> &inputs, size_t threads) const
+{
+    Matrix outputs(inputs.rows(), m_layers.back().outputs());
+    predict(inputs, outputs, threads);
+
+    std::vector<int> classes(inputs.rows());
+    for (Eigen::Index m = 0; m < outputs.rows(); ++m)
+    {
+        Eigen::Index index;
+        outputs.row(m).maxCoeff(&index);
+        classes[m] = index;
+    }
+
+    return classes;
+}
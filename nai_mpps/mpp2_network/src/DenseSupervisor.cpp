@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <barrier>
+#include <atomic>
+#include "DenseSupervisor.h"
+
+DenseSupervisor::DenseSupervisor(TrainingOptions options, DecisionTable trainData, DecisionTable testData, DenseNetwork &network)
+    : m_options(options),
+      m_trainSet(trainData),
+      m_testSet(testData),
+      m_network(network),
+      m_optimizer(options.optimizer, options.learningRate, options.momentum, network.getLayers()),
+      m_random(options.seed)
+{
+    std::vector<DenseLayer> &layers = m_network.getLayers();
+    Activation output = layers.back().activation();
+    if (output != Activation::Softmax && output != Activation::Sigmoid)
+    {
+        throw std::logic_error("Cross-entropy training needs a Softmax or Sigmoid output layer");
+    }
+
+    if (m_options.batchSize == 0 || m_options.syncBatches == 0)
+    {
+        throw std::logic_error("Batch size and batches per synchronisation must be positive");
+    }
+
+    m_order.resize(m_trainSet.rows());
+    std::iota(m_order.begin(), m_order.end(), 0);
+
+    // Workers beyond the rows of a step would only wait at the barriers
+    const bool synchronous = m_options.mode == ParallelMode::Synchronous;
+    const size_t stepRows = synchronous ? m_options.batchSize * m_options.syncBatches : m_options.batchSize;
+    size_t workers = std::clamp<size_t>(m_options.threads, 1, std::max<size_t>(1, m_order.size()));
+    if (synchronous)
+    {
+        workers = std::min(workers, std::max<size_t>(1, std::min(stepRows, m_order.size()) / MIN_SHARD_ROWS));
+    }
+
+    m_workspaces.resize(workers);
+    for (auto &workspace : m_workspaces)
+    {
+        const size_t batch = synchronous ? (stepRows + workers - 1) / workers : stepRows;
+        if (!synchronous)
+        {
+            workspace.Snapshot = layers;
+        }
+
+        workspace.Inputs = Matrix::Zero(batch, layers.front().inputs());
+        workspace.Targets = Matrix::Zero(batch, layers.back().outputs());
+        for (const auto &layer : layers)
+        {
+            workspace.Activations.push_back(Matrix::Zero(batch, layer.outputs()));
+            workspace.Deltas.push_back(Matrix::Zero(batch, layer.outputs()));
+            workspace.WeightGradients.push_back(Matrix::Zero(layer.inputs(), layer.outputs()));
+            workspace.BiasGradients.push_back(RowVector::Zero(layer.outputs()));
+        }
+    }
+};
+
+void DenseSupervisor::computeGradients(Workspace &workspace, const std::vector<DenseLayer> &layers, size_t first, size_t count, size_t batchRows)
+{
+    const size_t columns = workspace.Inputs.cols();
+    if (count == 0)
+    {
+        for (size_t l = 0; l < layers.size(); ++l)
+        {
+            workspace.WeightGradients[l].setZero();
+            workspace.BiasGradients[l].setZero();
+        }
+
+        return;
+    }
+
+    workspace.Targets.topRows(count).setZero();
+    for (size_t r = 0; r < count; ++r)
+    {
+        const size_t m = m_order[first + r];
+        workspace.Inputs.row(r) = Eigen::Map<const RowVector>(m_trainSet.matrix()[m].data(), columns);
+        workspace.Targets(r, m_trainSet.decision()[m]) = 1.0;
+    }
+
+    std::vector<Matrix> &activations = workspace.Activations;
+    std::vector<Matrix> &deltas = workspace.Deltas;
+    const auto inputs = workspace.Inputs.topRows(count);
+    const auto targets = workspace.Targets.topRows(count);
+    layers[0].feedForward(inputs, activations[0].topRows(count));
+    for (size_t l = 1; l < layers.size(); ++l)
+    {
+        layers[l].feedForward(activations[l - 1].topRows(count), activations[l].topRows(count));
+    }
+
+    // Both softmax + categorical and sigmoid + binary cross-entropy give dL/dz = (a - y) / N
+    const auto outputs = activations.back().topRows(count);
+    workspace.Loss -= (targets.array() * (outputs.array() + 1e-12).log()).sum();
+    if (layers.back().activation() == Activation::Sigmoid)
+    {
+        workspace.Loss -= ((1.0 - targets.array()) * (1.0 - outputs.array() + 1e-12).log()).sum();
+    }
+
+    deltas.back().topRows(count) = (outputs - targets) / (double)batchRows;
+    for (size_t l = layers.size() - 1; l > 0; --l)
+    {
+        layers[l].backPropagate(activations[l - 1].topRows(count),
+                                deltas[l].topRows(count),
+                                workspace.WeightGradients[l],
+                                workspace.BiasGradients[l],
+                                deltas[l - 1].topRows(count));
+        layers[l - 1].activationDerivative(activations[l - 1].topRows(count), deltas[l - 1].topRows(count));
+    }
+
+    layers[0].backPropagate(inputs, deltas[0].topRows(count), workspace.WeightGradients[0], workspace.BiasGradients[0], m_noDelta);
+}
+
+void DenseSupervisor::trainSynchronous()
+{
+    std::vector<DenseLayer> &layers = m_network.getLayers();
+    const size_t threads = m_workspaces.size();
+    const size_t stepRows = m_options.batchSize * m_options.syncBatches;
+    const size_t steps = (m_order.size() + stepRows - 1) / stepRows;
+    std::barrier sync(threads);
+
+    auto worker = [&](size_t t) {
+        Workspace &workspace = m_workspaces[t];
+        for (size_t step = 0; step < steps; ++step)
+        {
+            // Fixed shard boundaries keep the result independent of scheduling
+            const size_t first = step * stepRows;
+            const size_t count = std::min(stepRows, m_order.size() - first);
+            const size_t shardFirst = first + count * t / threads;
+            const size_t shardLast = first + count * (t + 1) / threads;
+            computeGradients(workspace, layers, shardFirst, shardLast - shardFirst, count);
+            sync.arrive_and_wait();
+
+            // Pairwise tree reduction into workspace 0, log2(threads) levels
+            for (size_t stride = 1; stride < threads; stride *= 2)
+            {
+                if (t % (2 * stride) == 0 && t + stride < threads)
+                {
+                    const Workspace &other = m_workspaces[t + stride];
+                    for (size_t l = 0; l < layers.size(); ++l)
+                    {
+                        workspace.WeightGradients[l] += other.WeightGradients[l];
+                        workspace.BiasGradients[l] += other.BiasGradients[l];
+                    }
+                }
+
+                sync.arrive_and_wait();
+            }
+
+            if (t == 0)
+            {
+                m_optimizer.step(layers, workspace.WeightGradients, workspace.BiasGradients);
+            }
+
+            sync.arrive_and_wait();
+        }
+    };
+
+    if (threads == 1)
+    {
+        worker(0);
+        return;
+    }
+
+    std::vector<std::thread> workers{};
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(worker, t);
+    }
+
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+}
+
+void DenseSupervisor::trainHogwild()
+{
+    std::vector<DenseLayer> &layers = m_network.getLayers();
+    const size_t threads = m_workspaces.size();
+
+    auto update = [&](Eigen::Ref<Matrix> parameters, const Eigen::Ref<const Matrix> &gradients) {
+        for (Eigen::Index i = 0; i < gradients.size(); ++i)
+        {
+            const double gradient = gradients.data()[i];
+            if (gradient == 0)
+            {
+                continue;
+            }
+
+            std::atomic_ref<double>(parameters.data()[i]).fetch_add(-m_options.learningRate * gradient, std::memory_order_relaxed);
+        }
+    };
+
+    auto load = [](Eigen::Ref<Matrix> snapshot, Eigen::Ref<Matrix> parameters) {
+        for (Eigen::Index i = 0; i < parameters.size(); ++i)
+        {
+            snapshot.data()[i] = std::atomic_ref<double>(parameters.data()[i]).load(std::memory_order_relaxed);
+        }
+    };
+
+    auto worker = [&](size_t t) {
+        Workspace &workspace = m_workspaces[t];
+        const size_t shardFirst = m_order.size() * t / threads;
+        const size_t shardLast = m_order.size() * (t + 1) / threads;
+        for (size_t first = shardFirst; first < shardLast; first += m_options.batchSize)
+        {
+            const size_t count = std::min(m_options.batchSize, shardLast - first);
+            for (size_t l = 0; l < layers.size(); ++l)
+            {
+                load(workspace.Snapshot[l].weights(), layers[l].weights());
+                load(workspace.Snapshot[l].bias(), layers[l].bias());
+            }
+
+            computeGradients(workspace, workspace.Snapshot, first, count, count);
+            for (size_t l = 0; l < layers.size(); ++l)
+            {
+                update(layers[l].weights(), workspace.WeightGradients[l]);
+                update(layers[l].bias(), workspace.BiasGradients[l]);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers{};
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(worker, t);
+    }
+
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+}
+
+void DenseSupervisor::train()
+{
+    for (uint32_t epoch = 0; epoch < m_options.epochs; ++epoch)
+    {
+        std::shuffle(m_order.begin(), m_order.end(), m_random);
+        for (auto &workspace : m_workspaces)
+        {
+            workspace.Loss = 0;
+        }
+
+        if (m_options.mode == ParallelMode::Hogwild)
+        {
+            trainHogwild();
+        }
+        else
+        {
+            trainSynchronous();
+        }
+
+        double loss = 0;
+        for (const auto &workspace : m_workspaces)
+        {
+            loss += workspace.Loss;
+        }
+
+        m_loss = loss / m_order.size();
+    }
+}
+
+double DenseSupervisor::getAccuracy()
+{
+    int correct = 0;
+    size_t total = m_testSet.rows();
+    std::vector<int> results = m_network.classify(asMatrix(m_testSet), m_options.threads);
+    for (size_t m = 0; m < total; ++m)
+    {
+        if (results[m] == m_testSet.decision()[m])
+        {
+            correct++;
+        }
+    }
+
+    return (double)correct / total * 100;
+}
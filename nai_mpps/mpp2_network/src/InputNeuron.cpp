@@ -2,7 +2,7 @@
 
 InputNeuron::InputNeuron(size_t index) : m_index(index){};
 
-void InputNeuron::feedForward(const std::vector<double> &inputs)
+void InputNeuron::feedForward(std::span<const double> inputs)
 {
     m_output = inputs[m_index];
 };
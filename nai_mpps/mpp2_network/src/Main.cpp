@@ -5,14 +5,20 @@
 #include <queue>
 #include <stdexcept>
 #include <time.h>
+#include <thread>
 
 #include "Supervisor.h"
+#include "DenseNetwork.h"
+#include "DenseSupervisor.h"
+#include "StaticNetwork.h"
+#include "QuantizedNetwork.h"
 #include "InputNeuron.h"
 #include "BiasNeuron.h"
 #include "Perceptron.h"
 #include "OutputNeuron.h"
 #include "DecisionTable.h"
 #include "Utils.h"
+#include "Random.h"
 
 std::unordered_map<std::string, int> decision_map =
     {
@@ -20,7 +26,7 @@ std::unordered_map<std::string, int> decision_map =
         {"Iris-versicolor", 1},
         {"Iris-virginica", 2}};
 
-void constructTopology(DecisionTable &trainTable, std::vector<Layer> &topology)
+void constructTopology(DecisionTable &trainTable, std::vector<Layer> &topology, Random &random)
 {
     topology.push_back({});
     topology.push_back({});
@@ -39,7 +45,8 @@ void constructTopology(DecisionTable &trainTable, std::vector<Layer> &topology)
             trainTable.columns(),
             1.0,
             0.1,
-            topology[0]));
+            topology[0],
+            random));
     }
 
     topology[2].push_back(std::make_unique<OutputNeuron>());
@@ -48,7 +55,11 @@ void constructTopology(DecisionTable &trainTable, std::vector<Layer> &topology)
 int main(int argc, char const *argv[])
 {
     setlocale(LC_ALL, "pl-PL");
-    srand(time(NULL));
+
+    // Optional third argument reproduces a previous run
+    uint64_t seed = argc > 3 ? std::stoull(argv[3]) : (uint64_t)time(NULL);
+    std::cout << "Seed: " << seed << std::endl;
+    Random random(seed);
 
     DecisionTable trainTable(decision_map);
     DecisionTable testTable(decision_map);
@@ -73,7 +84,7 @@ int main(int argc, char const *argv[])
     }
 
     std::vector<Layer> irisTopology{};
-    constructTopology(trainTable, irisTopology);
+    constructTopology(trainTable, irisTopology, random);
 
     Network network(irisTopology);
     Supervisor supervisor(10000, trainTable, testTable, network);
@@ -82,5 +93,44 @@ int main(int argc, char const *argv[])
 
     std::cout << accuracy << std::endl;
 
+    // Same trained weights, evaluated as one matrix product per layer
+    DenseNetwork denseNetwork(irisTopology);
+    std::cout << supervisor.getAccuracy(denseNetwork) << std::endl;
+
+    // Fixed-shape copy of the Iris network, must agree with the dynamic one on every row
+    using IrisNetwork = StaticNetwork<4, 3, 1>;
+    IrisNetwork irisNetwork = IrisNetwork::fromTopology(irisTopology);
+    int agreements = 0;
+    for (size_t m = 0; m < testTable.rows(); ++m)
+    {
+        IrisNetwork::Sample sample{};
+        std::copy(testTable.matrix()[m].begin(), testTable.matrix()[m].end(), sample.begin());
+        network.feedForward(testTable.matrix()[m]);
+        if (irisNetwork.getResult(sample) == network.getResult())
+        {
+            agreements++;
+        }
+    }
+
+    std::cout << "Static network agreement: " << agreements << "/" << testTable.rows() << std::endl;
+    if ((size_t)agreements != testTable.rows())
+    {
+        throw std::logic_error("Static network disagrees with the dynamic network");
+    }
+
+    // Multi-layer perceptron trained with mini-batch gradient descent
+    DenseNetwork mlp({trainTable.columns(), 8, decision_map.size()}, {Activation::Tanh, Activation::Softmax}, random);
+    TrainingOptions options{};
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    options.seed = random();
+    DenseSupervisor mlpSupervisor(options, trainTable, testTable, mlp);
+    mlpSupervisor.train();
+    std::cout << "MLP loss: " << mlpSupervisor.getLoss() << std::endl;
+    std::cout << "MLP accuracy: " << mlpSupervisor.getAccuracy() << std::endl;
+
+    // int8 copy of the trained MLP, calibrated on the training rows
+    QuantizedNetwork quantizedMlp(mlp, trainTable);
+    printQuantizationReport(mlp, quantizedMlp, testTable);
+
     return 0;
 };
@@ -1,7 +1,19 @@
 #include "assert.h"
+#include <algorithm>
 #include "Network.h"
 
-Network::Network(std::vector<Layer> &topology)
+static size_t widestLayer(const std::vector<Layer> &topology)
+{
+    size_t width = 0;
+    for (const auto &layer : topology)
+    {
+        width = std::max(width, layer.size());
+    }
+
+    return width;
+}
+
+Network::Network(std::vector<Layer> &topology) : m_arena(widestLayer(topology))
 {
     assert(topology.empty() == false);
 
@@ -15,19 +27,17 @@ std::vector<Layer> Network::getLayers() const
 
 void Network::feedForward(const std::vector<double> &inputs)
 {
-    std::vector<double> previous = inputs;
-    std::vector<double> current{};
-
+    std::span<const double> previous(inputs);
     for (size_t layerNum = 0; layerNum < m_layers.size(); ++layerNum)
     {
+        std::span<double> current = m_arena.next(m_layers[layerNum].size());
         for (size_t neuronNum = 0; neuronNum < m_layers[layerNum].size(); ++neuronNum)
         {
             m_layers[layerNum][neuronNum]->feedForward(previous);
-            current.push_back(m_layers[layerNum][neuronNum]->getOutput());
+            current[neuronNum] = m_layers[layerNum][neuronNum]->getOutput();
         }
 
         previous = current;
-        current.clear();
     }
 }
 
@@ -0,0 +1,54 @@
+#include <cmath>
+#include "assert.h"
+#include "Optimizer.h"
+
+Optimizer::Optimizer(OptimizerType type, double learningRate, double momentum, const std::vector<DenseLayer> &layers)
+    : m_type(type), m_learningRate(learningRate), m_momentum(momentum)
+{
+    for (const auto &layer : layers)
+    {
+        m_weightMoments.push_back(Matrix::Zero(layer.inputs(), layer.outputs()));
+        m_biasMoments.push_back(RowVector::Zero(layer.outputs()));
+        if (m_type == OptimizerType::Adam)
+        {
+            m_weightVariances.push_back(Matrix::Zero(layer.inputs(), layer.outputs()));
+            m_biasVariances.push_back(RowVector::Zero(layer.outputs()));
+        }
+    }
+};
+
+void Optimizer::step(std::vector<DenseLayer> &layers,
+                     const std::vector<Matrix> &weightGradients,
+                     const std::vector<RowVector> &biasGradients)
+{
+    assert(layers.size() == m_weightMoments.size());
+    m_steps++;
+
+    if (m_type == OptimizerType::Momentum)
+    {
+        for (size_t l = 0; l < layers.size(); ++l)
+        {
+            m_weightMoments[l] = m_momentum * m_weightMoments[l] - m_learningRate * weightGradients[l];
+            m_biasMoments[l] = m_momentum * m_biasMoments[l] - m_learningRate * biasGradients[l];
+            layers[l].weights() += m_weightMoments[l];
+            layers[l].bias() += m_biasMoments[l];
+        }
+
+        return;
+    }
+
+    // Bias corrections of both moments folded into the step size
+    double stepSize = m_learningRate *
+                      std::sqrt(1.0 - std::pow(m_beta2, (double)m_steps)) /
+                      (1.0 - std::pow(m_beta1, (double)m_steps));
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+        m_weightMoments[l] = m_beta1 * m_weightMoments[l] + (1.0 - m_beta1) * weightGradients[l];
+        m_biasMoments[l] = m_beta1 * m_biasMoments[l] + (1.0 - m_beta1) * biasGradients[l];
+        m_weightVariances[l].array() = m_beta2 * m_weightVariances[l].array() + (1.0 - m_beta2) * weightGradients[l].array().square();
+        m_biasVariances[l].array() = m_beta2 * m_biasVariances[l].array() + (1.0 - m_beta2) * biasGradients[l].array().square();
+
+        layers[l].weights().array() -= stepSize * m_weightMoments[l].array() / (m_weightVariances[l].array().sqrt() + m_epsilon);
+        layers[l].bias().array() -= stepSize * m_biasMoments[l].array() / (m_biasVariances[l].array().sqrt() + m_epsilon);
+    }
+};
@@ -3,7 +3,7 @@
 
 OutputNeuron::OutputNeuron(){};
 
-void OutputNeuron::feedForward(const std::vector<double> &inputs)
+void OutputNeuron::feedForward(std::span<const double> inputs)
 {
     auto it = std::max_element(inputs.begin(), inputs.end());
     m_output = std::distance(inputs.begin(), it);
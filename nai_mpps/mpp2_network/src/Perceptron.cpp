@@ -1,19 +1,22 @@
 #include "Perceptron.h"
 #include "Utils.h"
 
-Perceptron::Perceptron(int label, size_t dimensions, double threshold, double learningRate, Layer &prevLayer)
+#define MAX_CORRECTIONS 1000
+
+Perceptron::Perceptron(int label, size_t dimensions, double threshold, double learningRate, Layer &prevLayer, Random &random)
     : m_label(label), m_dimensions(dimensions), m_threshold(threshold), m_learningRate(learningRate), m_prevLayer(prevLayer)
 {
     m_weights = {};
     for (size_t i = 0; i < m_dimensions; i++)
     {
-        m_weights.push_back(rand() % 10);
+        m_weights.push_back(random.below(10));
     }
 
     m_weights.push_back(-m_threshold);
+    m_inputs.resize(m_weights.size());
 };
 
-void Perceptron::feedForward(const std::vector<double> &inputs)
+void Perceptron::feedForward(std::span<const double> inputs)
 {
     // normalizeW();
     m_output = dot(m_weights, inputs);
@@ -37,14 +40,15 @@ void Perceptron::normalizeW()
 
 void Perceptron::backPropagate(int answer)
 {
-    std::vector<double> X {};
+    std::vector<double> &X = m_inputs;
     for (size_t i = 0; i < m_weights.size(); ++i)
     {
-        X.push_back(m_prevLayer[i]->getOutput());
+        X[i] = m_prevLayer[i]->getOutput();
     }
-    
+
     int step_result = m_output;
-    while ((step_result = dot(m_weights, X) >= 0) != answer)
+    size_t corrections = 0;
+    while ((step_result = dot(m_weights, X) >= 0) != answer && corrections++ < MAX_CORRECTIONS)
     {
         for (size_t i = 0; i < m_weights.size(); ++i)
         {
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include "assert.h"
+#include "QuantizedNetwork.h"
+#include "Activations.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Rows are padded to whole 16 byte vectors so the kernels need no tail
+#define QUANT_ALIGN 16
+
+static double symmetricScale(double maxMagnitude)
+{
+    return maxMagnitude > 0 ? maxMagnitude / 127.0 : 1.0;
+}
+
+static int8_t quantize(double value, double scale)
+{
+    double q = std::nearbyint(value / scale);
+    return (int8_t)std::min(127.0, std::max(-127.0, q));
+}
+
+// Sum of a[i] * b[i] over length bytes (a multiple of QUANT_ALIGN)
+static int32_t dotInt8(const int8_t *a, const int8_t *b, size_t length)
+{
+#if defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (size_t i = 0; i < length; i += 16)
+    {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(a + i)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+#elif defined(_M_X64) || defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+    for (size_t i = 0; i < length; i += 16)
+    {
+        // Sign-extend the bytes to 16 bits by interleaving them with their sign masks
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i signA = _mm_cmpgt_epi8(zero, va);
+        __m128i signB = _mm_cmpgt_epi8(zero, vb);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(va, signA), _mm_unpacklo_epi8(vb, signB)));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(va, signA), _mm_unpackhi_epi8(vb, signB)));
+    }
+
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+#else
+    int32_t sum = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        sum += (int32_t)a[i] * b[i];
+    }
+
+    return sum;
+#endif
+}
+
+QuantizedNetwork::QuantizedNetwork(const DenseNetwork &network, const DecisionTable &calibration)
+{
+    if (calibration.rows() == 0)
+    {
+        throw std::logic_error("Quantization needs at least one calibration row");
+    }
+
+    // Float activations of the calibration rows give every layer's input range
+    Matrix activations = asMatrix(calibration);
+    for (const DenseLayer &layer : network.getLayers())
+    {
+        QuantizedLayer quantized{};
+        quantized.Inputs = layer.inputs();
+        quantized.Outputs = layer.outputs();
+        quantized.Stride = (layer.inputs() + QUANT_ALIGN - 1) / QUANT_ALIGN * QUANT_ALIGN;
+        quantized.WeightScale = symmetricScale(layer.weights().cwiseAbs().maxCoeff());
+        quantized.InputScale = symmetricScale(activations.cwiseAbs().maxCoeff());
+        quantized.Bias = layer.bias();
+        quantized.Function = layer.activation();
+
+        quantized.Weights.assign(quantized.Outputs * quantized.Stride, 0);
+        for (size_t o = 0; o < quantized.Outputs; ++o)
+        {
+            for (size_t i = 0; i < quantized.Inputs; ++i)
+            {
+                quantized.Weights[o * quantized.Stride + i] = quantize(layer.weights()(i, o), quantized.WeightScale);
+            }
+        }
+
+        Matrix outputs(activations.rows(), layer.outputs());
+        layer.feedForward(activations, outputs);
+        activations = std::move(outputs);
+        m_layers.push_back(std::move(quantized));
+    }
+};
+
+void QuantizedNetwork::predict(const Eigen::Ref<const Matrix> &inputs, Eigen::Ref<Matrix> outputs) const
+{
+    assert((size_t)inputs.cols() == m_layers.front().Inputs);
+    assert(outputs.rows() == inputs.rows() && (size_t)outputs.cols() == m_layers.back().Outputs);
+
+    size_t stride = 0;
+    size_t width = 0;
+    for (const auto &layer : m_layers)
+    {
+        stride = std::max(stride, layer.Stride);
+        width = std::max(width, layer.Outputs);
+    }
+
+    std::vector<int8_t> quantizedRows(BLOCK_ROWS * stride, 0);
+    Matrix scratch[2] = {Matrix(BLOCK_ROWS, width), Matrix(BLOCK_ROWS, width)};
+    const size_t rows = inputs.rows();
+    for (size_t first = 0; first < rows; first += BLOCK_ROWS)
+    {
+        const size_t count = std::min<size_t>(BLOCK_ROWS, rows - first);
+        for (size_t l = 0; l < m_layers.size(); ++l)
+        {
+            const QuantizedLayer &layer = m_layers[l];
+            ConstMatrixView input = l == 0
+                                        ? ConstMatrixView(inputs.row(first).data(), count, layer.Inputs, Eigen::OuterStride<>(inputs.outerStride()))
+                                        : ConstMatrixView(scratch[(l - 1) % 2].data(), count, layer.Inputs, Eigen::OuterStride<>(width));
+            MatrixView current = l == m_layers.size() - 1
+                                     ? MatrixView(outputs.row(first).data(), count, layer.Outputs, Eigen::OuterStride<>(outputs.outerStride()))
+                                     : MatrixView(scratch[l % 2].data(), count, layer.Outputs, Eigen::OuterStride<>(width));
+
+            for (size_t r = 0; r < count; ++r)
+            {
+                int8_t *row = quantizedRows.data() + r * stride;
+                for (size_t i = 0; i < layer.Inputs; ++i)
+                {
+                    row[i] = quantize(input(r, i), layer.InputScale);
+                }
+
+                std::fill(row + layer.Inputs, row + layer.Stride, 0);
+            }
+
+            const double dequantize = layer.WeightScale * layer.InputScale;
+            for (size_t r = 0; r < count; ++r)
+            {
+                const int8_t *row = quantizedRows.data() + r * stride;
+                for (size_t o = 0; o < layer.Outputs; ++o)
+                {
+                    int32_t acc = dotInt8(row, layer.Weights.data() + o * layer.Stride, layer.Stride);
+                    current(r, o) = acc * dequantize + layer.Bias[o];
+                }
+            }
+
+            dispatchActivation(layer.Function, [&](auto func) {
+                decltype(func)::apply(current);
+            });
+        }
+    }
+};
+
+std::vector<int> QuantizedNetwork::classify(const Eigen::Ref<const Matrix> &inputs) const
+{
+    Matrix outputs(inputs.rows(), m_layers.back().Outputs);
+    predict(inputs, outputs);
+
+    std::vector<int> classes(inputs.rows());
+    for (Eigen::Index m = 0; m < outputs.rows(); ++m)
+    {
+        Eigen::Index index;
+        outputs.row(m).maxCoeff(&index);
+        classes[m] = index;
+    }
+
+    return classes;
+};
+
+size_t QuantizedNetwork::sizeInBytes() const
+{
+    size_t bytes = 0;
+    for (const auto &layer : m_layers)
+    {
+        bytes += layer.Outputs * layer.Stride * sizeof(int8_t) +
+                 layer.Outputs * sizeof(double) +
+                 2 * sizeof(double);
+    }
+
+    return bytes;
+};
+
+void printQuantizationReport(const DenseNetwork &network, const QuantizedNetwork &quantized, const DecisionTable &table)
+{
+    std::vector<int> floatResults = network.classify(asMatrix(table));
+    std::vector<int> quantizedResults = quantized.classify(asMatrix(table));
+
+    int floatCorrect = 0;
+    int quantizedCorrect = 0;
+    int agreements = 0;
+    for (size_t m = 0; m < table.rows(); ++m)
+    {
+        floatCorrect += floatResults[m] == table.decision()[m];
+        quantizedCorrect += quantizedResults[m] == table.decision()[m];
+        agreements += floatResults[m] == quantizedResults[m];
+    }
+
+    size_t floatBytes = 0;
+    for (const auto &layer : network.getLayers())
+    {
+        floatBytes += (layer.inputs() + 1) * layer.outputs() * sizeof(double);
+    }
+
+    const double total = (double)table.rows();
+    const std::ios_base::fmtflags flags = std::cout.flags();
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Float accuracy: " << floatCorrect / total * 100 << "%" << std::endl;
+    std::cout << "Int8 accuracy: " << quantizedCorrect / total * 100 << "%" << std::endl;
+    std::cout << "Agreement: " << agreements / total * 100 << "%" << std::endl;
+    std::cout << "Model size: " << floatBytes << " B (double) -> " << quantized.sizeInBytes() << " B (int8)" << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+};
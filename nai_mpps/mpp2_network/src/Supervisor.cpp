@@ -6,6 +6,7 @@ Supervisor::Supervisor(uint32_t iterations, DecisionTable trainData, DecisionTab
 void Supervisor::train()
 {
     size_t iterations = 0;
+    std::vector<int> answers(3, 0);
     while (iterations < m_iterations)
     {
         for (size_t m = 0; m < m_trainSet.rows(); ++m)
@@ -13,18 +14,11 @@ void Supervisor::train()
             m_network.feedForward(m_trainSet.matrix()[m]);
 
             int answer = m_trainSet.decision()[m];
-            std::vector<int> answers {};
-            for (size_t i = 0; i < 3; i++)
+            for (size_t i = 0; i < answers.size(); i++)
             {
-                if(answer == i)
-                {
-                    answers.push_back(1);
-                    continue;
-                }
-
-                answers.push_back(0);
+                answers[i] = answer == i ? 1 : 0;
             }
-            
+
             m_network.backPropagate(answers);
         }
 
@@ -47,5 +41,21 @@ double Supervisor::getAccuracy()
         }
     }
 
+    return (double)correct / total * 100;
+}
+
+double Supervisor::getAccuracy(DenseNetwork &network)
+{
+    int correct = 0;
+    size_t total = m_testSet.rows();
+    std::vector<int> results = network.classify(asMatrix(m_testSet));
+    for (size_t m = 0; m < total; ++m)
+    {
+        if (results[m] == m_testSet.decision()[m])
+        {
+            correct++;
+        }
+    }
+
     return (double)correct / total * 100;
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+// Standalone check that a warmed-up Network trains without touching the heap:
+// every operator new is counted, and after a few warm-up samples a run of
+// feedForward + backPropagate pairs must not add to the count.
+// Built by the "cl.exe allocation check" task; exits with 1 on failure.
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "BiasNeuron.h"
+#include "InputNeuron.h"
+#include "Network.h"
+#include "OutputNeuron.h"
+#include "Perceptron.h"
+#include "Random.h"
+
+#define WARMUP_PASSES 4
+#define CHECKED_PASSES 1000
+
+static std::atomic<size_t> allocations{0};
+
+void *operator new(size_t size)
+{
+    allocations++;
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+int main()
+{
+    // Same shape as the Iris network in Main.cpp: 4 inputs and a bias, one
+    // perceptron per class, an argmax output
+    const size_t inputs = 4;
+    const size_t classes = 3;
+    Random random(1);
+    std::vector<Layer> topology(3);
+    for (size_t i = 0; i < inputs; ++i)
+    {
+        topology[0].push_back(std::make_unique<InputNeuron>(i));
+    }
+
+    topology[0].push_back(std::make_unique<BiasNeuron>(1.0));
+    for (size_t i = 0; i < classes; ++i)
+    {
+        topology[1].push_back(std::make_unique<Perceptron>(i, inputs, 1.0, 0.1, topology[0], random));
+    }
+
+    topology[2].push_back(std::make_unique<OutputNeuron>());
+    Network network(topology);
+
+    std::vector<std::vector<double>> samples(classes, std::vector<double>(inputs));
+    for (size_t c = 0; c < classes; ++c)
+    {
+        for (size_t i = 0; i < inputs; ++i)
+        {
+            samples[c][i] = random.uniform();
+        }
+    }
+
+    std::vector<int> answers(classes, 0);
+    auto pass = [&](size_t n) {
+        const size_t label = n % classes;
+        network.feedForward(samples[label]);
+        for (size_t i = 0; i < classes; ++i)
+        {
+            answers[i] = i == label ? 1 : 0;
+        }
+
+        network.backPropagate(answers);
+    };
+
+    for (size_t n = 0; n < WARMUP_PASSES; ++n)
+    {
+        pass(n);
+    }
+
+    // Building the network allocates, so a count of 0 here means the
+    // replacement operator new is not the one in use
+    const size_t before = allocations;
+    if (before == 0)
+    {
+        std::cout << "operator new is not counted" << std::endl;
+        return 1;
+    }
+
+    for (size_t n = 0; n < CHECKED_PASSES; ++n)
+    {
+        pass(n);
+    }
+
+    const size_t steady = allocations - before;
+    std::cout << "Allocations in " << CHECKED_PASSES << " warmed-up passes: " << steady << std::endl;
+    return steady == 0 ? 0 : 1;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Interleaved scanners per document; each follows its own dependent chain of table loads
+#define SCAN_LANES 8
+// Scans keep one 16 bit count per group in a 64 bit register
+#define MAX_PATTERN_GROUPS 4
+
+// Multi-pattern matcher compiled into a dense DFA. Patterns are byte strings
+// over an already folded alphabet and each belongs to one of `groups` groups;
+// a scan counts the matches of every group in one pass over the input.
+//
+// Input bytes go through the fold table first and are then reduced to symbols:
+// every byte that occurs in some pattern has its own symbol and all others
+// share one, so a state's row of transitions is only the number of distinct
+// pattern bytes + 1, rounded up to a power of two. States are the offsets of
+// their rows, so a transition is one add and one load. The unused tail of every
+// row holds the state's per-group match counts (its own patterns plus those of
+// its suffix links) packed into 64 bits, so a scan adds that word per byte from
+// the cache line it reads anyway instead of branching on matches.
+class AhoCorasick
+{
+private:
+    uint8_t m_symbols[256];
+    uint32_t m_shift = 0;
+    size_t m_groups;
+    uint8_t m_boundary;
+    std::vector<uint16_t> m_next;
+    std::vector<uint32_t> m_emissions;
+    // Bytes after which the packed counts have to be flushed before a field can overflow
+    size_t m_flushBytes = 0;
+
+    // Adds packed per-group counts to totals[0..groups)
+    void unpack(uint64_t packed, uint64_t *totals) const;
+    // Scans one stretch with a single lane and returns the state it ends in
+    uint16_t scan(uint16_t state, const uint8_t *bytes, size_t length, uint64_t *totals) const;
+
+public:
+    // fold maps every input byte onto the alphabet the patterns are written in.
+    // The folded boundary byte may only be the first or last byte of a pattern:
+    // then no match spans a boundary, and after one the automaton continues
+    // exactly as from next(root(), boundary), which lets count() split there.
+    AhoCorasick(const std::vector<std::pair<std::string, uint32_t>> &patterns, size_t groups, const uint8_t *fold, uint8_t boundary);
+    AhoCorasick() = delete;
+    AhoCorasick(const AhoCorasick &other) = delete;
+    AhoCorasick &operator=(const AhoCorasick &other) = delete;
+    AhoCorasick(AhoCorasick &&) = delete;
+    AhoCorasick &operator=(AhoCorasick &&) = delete;
+    ~AhoCorasick() = default;
+
+    size_t groups() const { return m_groups; };
+    uint8_t boundary() const { return m_boundary; };
+    size_t states() const { return m_next.size() >> m_shift; };
+
+    // Incremental use: the state before any input, one byte's transition and
+    // the per-group match counts (nullptr for none) of the state it leads to
+    uint16_t root() const { return 0; };
+    uint16_t next(uint16_t state, uint8_t byte) const { return m_next[state + m_symbols[byte]]; };
+    const uint32_t *emission(uint16_t state) const
+    {
+        const uint32_t *row = m_emissions.data() + (state >> m_shift) * m_groups;
+        for (size_t g = 0; g < m_groups; g++)
+        {
+            if (row[g] != 0)
+            {
+                return row;
+            }
+        }
+
+        return nullptr;
+    };
+
+    // Adds the matches in the input to counts[0..groups). The input is scanned as
+    // if enclosed in boundary bytes, so patterns may start at its first byte and
+    // end at its last. Long inputs are cut after boundary bytes into SCAN_LANES
+    // stretches that are scanned interleaved, each lane starting where a
+    // boundary leaves the automaton; this is exact only because of the
+    // constructor's restriction on where patterns hold the boundary.
+    void count(const char *data, size_t length, uint32_t *counts) const;
+};
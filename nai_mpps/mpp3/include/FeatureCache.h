@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Features.h"
+
+// Appended to a corpus directory's path to name its cache file
+#define CACHE_EXTENSION ".cache"
+// Bumped whenever the file layout or the feature extraction changes
+#define CACHE_VERSION 2
+
+// Features of previously parsed documents, stored in a compact binary file
+// next to the corpus. Entries are keyed by the document's path relative to the
+// corpus root and remember its size, modification time and content hash: a
+// document whose size and time are unchanged is not read at all, one that was
+// merely touched is read and hashed but not re-processed.
+class FeatureCache
+{
+public:
+    struct Entry
+    {
+        uint64_t Size = 0;
+        int64_t ModifiedTime = 0;
+        uint64_t Hash = 0;
+        Features Letters{};
+        SparseFeatures NGrams{};
+    };
+
+private:
+    std::string m_path;
+    std::unordered_map<std::string, Entry> m_entries;
+
+public:
+    // Loads the cache file if there is a compatible one; a missing, stale or
+    // damaged file just leaves the cache empty
+    explicit FeatureCache(const std::string &path);
+    FeatureCache() = delete;
+    FeatureCache(const FeatureCache &other) = delete;
+    FeatureCache &operator=(const FeatureCache &other) = delete;
+    FeatureCache(FeatureCache &&) = delete;
+    FeatureCache &operator=(FeatureCache &&) = delete;
+    ~FeatureCache() = default;
+
+    // nullptr when the document was never cached
+    const Entry *find(const std::string &key) const;
+    void store(const std::string &key, Entry entry);
+    // Drops every entry whose key is not in keys
+    void retain(const std::vector<std::string> &keys);
+    size_t size() const { return m_entries.size(); };
+
+    // Writes a temporary file and renames it over the cache file
+    void save() const;
+};
+
+// 64 bit FNV-1a of the bytes
+uint64_t contentHash(const char *data, size_t length);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// a-z followed by the Polish, German and Spanish letters with diacritics
+// (see DIACRITICS in Features.cpp), upper case folded onto lower case
+#define ASCII_LETTERS 26
+#define LETTERS_COUNT 44
+// One dimension per function-word list (see FUNCTION_WORDS in Features.cpp)
+#define FUNCTION_WORD_LISTS 4
+#define FEATURES_COUNT (LETTERS_COUNT + FUNCTION_WORD_LISTS)
+
+// Character 1..MAX_NGRAM-grams are hashed into NGRAM_BUCKETS buckets
+#define MAX_NGRAM 4
+#define NGRAM_BITS 12
+#define NGRAM_BUCKETS (1u << NGRAM_BITS)
+
+class AhoCorasick;
+
+// Relative letter frequencies of one document followed by its share of
+// function-word hits per list
+using Features = std::array<float, FEATURES_COUNT>;
+
+// L2-normalized n-gram counts of one document, non-zero buckets only
+struct SparseFeatures
+{
+    std::vector<uint32_t> Indices{};
+    std::vector<float> Values{};
+};
+
+// One document's features as views into wherever they are stored
+struct Sample
+{
+    const float *Letters;
+    const uint32_t *Indices;
+    const float *Values;
+    size_t NGrams;
+};
+
+inline Sample makeSample(const Features &letters, const SparseFeatures &ngrams)
+{
+    return {letters.data(), ngrams.Indices.data(), ngrams.Values.data(), ngrams.Indices.size()};
+}
+
+// Whole corpus in flat memory: one Features row per document
+struct Corpus
+{
+    std::vector<std::string> Languages{};
+    std::vector<Features> Documents{};
+    std::vector<SparseFeatures> NGrams{};
+    std::vector<int> Labels{};
+
+    // Index of the language, registering it when seen for the first time
+    int languageIndex(const std::string &language);
+};
+
+// Letter histogram over UTF-8 text in a single pass. Every byte goes through a
+// 256 entry case-folding table into four interleaved counters (no branches, all
+// non-ASCII bytes discarded); per 64 byte block an SSE2 compare finds the lead
+// bytes of the alphabet's two byte letters, which are added back from a second
+// table, so pure ASCII blocks cost one extra compare and branch. Fills only the
+// LETTERS_COUNT letter dimensions.
+void getDistribution(const char *data, size_t length, Features &result);
+void getDistribution(const std::string &str, Features &result);
+
+// Function-word hits of every list in one scan of the automaton over the bytes
+// as getNGrams folds them, i.e. whole words only. Fills the FUNCTION_WORD_LISTS
+// dimensions after the letters with each list's share of all hits.
+void getFunctionWords(const char *data, size_t length, Features &result);
+void getFunctionWords(const std::string &str, Features &result);
+// The automaton of all lists, compiled on first use; patterns are words enclosed in ' '
+const AhoCorasick &functionWords();
+
+// Hashed character n-grams in one pass over the bytes. Letters are lower-cased,
+// bytes >= 0x80 (UTF-8 sequences) kept and any other run of bytes collapses into
+// one space, so n-grams can span word boundaries. The last MAX_NGRAM bytes roll
+// through a 32 bit window and every suffix of it is hashed multiplicatively,
+// so nothing is allocated per n-gram.
+void getNGrams(const char *data, size_t length, SparseFeatures &result);
+void getNGrams(const std::string &str, SparseFeatures &result);
+
+// Per-byte steps of the two extractors, for callers that update features incrementally.
+// Letter bin of byte given the byte before it, LETTERS_COUNT when it is no letter
+uint32_t letterBin(uint8_t previous, uint8_t byte);
+// The byte as getNGrams sees it: lower-cased letter, byte >= 0x80 or ' '
+uint8_t foldByte(uint8_t byte);
+// Bucket of the n-gram made of the last n bytes of a rolling window
+uint32_t ngramBucket(uint32_t window, uint32_t n);
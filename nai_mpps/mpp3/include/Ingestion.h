@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include "Features.h"
+#include "ThreadPool.h"
+
+// Files handed to one pool job; amortizes the queue traffic over many small documents
+#define INGEST_BATCH 64
+
+// Appends every <path>/<language>/<document> file to the corpus. Files are
+// enumerated up front so the Documents/Labels rows can be preallocated, with
+// each language's documents in one contiguous block (languages and files in
+// sorted order). The files are then memory mapped and their letter and n-gram
+// features computed on the pool, every job writing straight into its own rows.
+// Documents found unchanged in <path>.cache (see FeatureCache) are not
+// processed again, and the cache is rewritten when anything changed.
+void parse(const std::string &path, Corpus &result, ThreadPool &pool);
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include "Features.h"
+#include "Perceptron.h"
+
+// Bytes of input the sliding window classifies
+#define STREAM_WINDOW 4096
+// Bytes read from the input per call
+#define STREAM_BUFFER (1 << 20)
+
+// [Begin, End) byte range of the input attributed to one language
+struct LanguageSpan
+{
+    size_t Begin;
+    size_t End;
+    size_t Language;
+};
+
+// Language identification over a sliding window of the last `window` input
+// bytes. The window's letter, n-gram and function-word counts are kept
+// incrementally: every byte adds its own letter, n-grams and the function words
+// it completes and takes back those of the byte that leaves the window, and each
+// perceptron's dot products move by the matching weights. Scoring is then a
+// handful of operations per perceptron, so the cost per byte does not depend on
+// the window size.
+// A decision is attributed to the middle of its window; whenever it changes,
+// the span of the previous language is emitted.
+class LanguageStream
+{
+private:
+    // What one input byte contributed, to take it back when it leaves
+    struct Contribution
+    {
+        uint8_t Letter;
+        uint8_t NGrams;
+        uint16_t Buckets[MAX_NGRAM];
+        uint16_t WordState;
+    };
+
+    const std::vector<Perceptron> &m_perceptrons;
+    size_t m_languages;
+    std::vector<float> m_weights;
+    size_t m_window;
+    std::vector<Contribution> m_ring;
+    std::vector<uint32_t> m_ngramCounts;
+    std::vector<double> m_letterDots;
+    std::vector<double> m_ngramDots;
+    std::vector<double> m_wordDots;
+    uint64_t m_letters = 0;
+    uint64_t m_squares = 0;
+    uint64_t m_wordHits = 0;
+
+    size_t m_position = 0;
+    uint8_t m_previous = 0;
+    uint32_t m_ngramWindow = ' ';
+    uint32_t m_filled = 1;
+    uint16_t m_wordState;
+
+    size_t m_language = SIZE_MAX;
+    size_t m_spanBegin = 0;
+
+    // Adds (sign 1) or takes back (sign -1) the function words ending in this automaton state
+    void countWords(uint16_t state, int sign);
+    void add(uint8_t byte, Contribution &contribution);
+    void remove(const Contribution &contribution);
+    size_t classify() const;
+    void decide(size_t center, std::vector<LanguageSpan> &spans);
+
+public:
+    LanguageStream(const std::vector<Perceptron> &perceptrons, size_t window = STREAM_WINDOW);
+    LanguageStream() = delete;
+    LanguageStream(const LanguageStream &other) = delete;
+    LanguageStream &operator=(const LanguageStream &other) = delete;
+    LanguageStream(LanguageStream &&) = delete;
+    LanguageStream &operator=(LanguageStream &&) = delete;
+    ~LanguageStream() = default;
+
+    // Appends the spans completed by these bytes
+    void feed(const char *data, size_t length, std::vector<LanguageSpan> &spans);
+    // Closes the last span at the end of the input
+    void finish(std::vector<LanguageSpan> &spans);
+};
+
+// Reads the whole file in STREAM_BUFFER chunks and prints "begin end language" per span
+void printLanguageSpans(std::FILE *file, const std::vector<Perceptron> &perceptrons, size_t window = STREAM_WINDOW);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Features.h"
+
+#define ALPHA 0.01f
+#define MAX_SCALE 1e6f
+
+float dot(const float *v1, const float *v2, size_t size);
+
+// Weights hold the FEATURES_COUNT dense weights followed by one weight per n-gram bucket.
+// They are stored divided by Scale, so the normalization after every delta rule
+// step is a single division and a sparse update touches only its non-zero buckets.
+struct Perceptron
+{
+    std::string Label;
+    float Threshold;
+    std::vector<float> Weights;
+    float Scale = 1.0f;
+    float WeightSum = 0.0f;
+
+    float predict(const Sample &input) const;
+    void deltaRule(const Sample &input, float desired, float output);
+    void normalize();
+};
+
+// Index of the perceptron with the strongest net for the document
+size_t answer(const Sample &input, const std::vector<Perceptron> &perceptrons);
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Features.h"
+#include "Perceptron.h"
+
+// Training stops after this many epochs or seconds even if the target accuracy is never reached
+#define MAX_EPOCHS 1000
+#define MAX_TRAINING_SECONDS 60.0
+
+// A corpus packed once for training: letter frequencies as a row-major
+// Rows x FEATURES_COUNT matrix, n-grams in compressed sparse rows (row r owns
+// Indices/Values[Offsets[r], Offsets[r + 1])), so an epoch is one forward
+// stream over three flat arrays.
+struct TrainingMatrix
+{
+    size_t Rows = 0;
+    std::vector<float> Letters{};
+    std::vector<uint32_t> Offsets{};
+    std::vector<uint32_t> Indices{};
+    std::vector<float> Values{};
+    std::vector<int> Labels{};
+
+    explicit TrainingMatrix(const Corpus &corpus);
+
+    Sample row(size_t r) const
+    {
+        return {Letters.data() + r * FEATURES_COUNT, Indices.data() + Offsets[r], Values.data() + Offsets[r], Offsets[r + 1] - Offsets[r]};
+    };
+};
+
+struct TrainingResult
+{
+    size_t Epochs = 0;
+    size_t BestEpoch = 0;
+    float Accuracy = 0.0f;
+    double Seconds = 0.0;
+    bool Converged = false;
+};
+
+// Accuracy in percent, with every row read once and scored against all
+// perceptrons in the same pass; predictions (if given) receive each row's answer
+float evaluate(const TrainingMatrix &matrix, const std::vector<Perceptron> &perceptrons, std::vector<int> *predictions = nullptr);
+
+// One delta rule pass over all rows
+void trainEpoch(const TrainingMatrix &matrix, std::vector<Perceptron> &perceptrons);
+
+// Trains until the test accuracy is within tolerance of 100%, or until an
+// epoch or time budget runs out. The perceptrons end up as they were after the
+// epoch with the best test accuracy, which is what Accuracy reports.
+TrainingResult train(const TrainingMatrix &train_data, const TrainingMatrix &test_data, std::vector<Perceptron> &perceptrons,
+                     float tolerance, size_t max_epochs = MAX_EPOCHS, double max_seconds = MAX_TRAINING_SECONDS);
@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include "AhoCorasick.h"
+
+// Inputs shorter than this are scanned by a single lane
+#define MIN_LANE_BYTES 64
+#define PACKED_BITS 16
+#define PACKED_MASK 0xFFFFull
+// Transitions a state's packed counts take up at the end of its row
+#define PACKED_SLOTS (sizeof(uint64_t) / sizeof(uint16_t))
+
+// Packed counts of the state whose row starts at offset state
+static uint64_t packedAt(const uint16_t *transitions, size_t stride, size_t state)
+{
+    uint64_t packed;
+    std::memcpy(&packed, transitions + state + stride - PACKED_SLOTS, sizeof(packed));
+    return packed;
+}
+
+AhoCorasick::AhoCorasick(const std::vector<std::pair<std::string, uint32_t>> &patterns, size_t groups, const uint8_t *fold, uint8_t boundary)
+    : m_groups(groups), m_boundary(boundary)
+{
+    if (groups == 0 || groups > MAX_PATTERN_GROUPS)
+    {
+        throw std::invalid_argument("Aho-Corasick supports 1 to " + std::to_string(MAX_PATTERN_GROUPS) + " pattern groups");
+    }
+
+    // One symbol per distinct pattern byte, symbol 0 for every other byte
+    uint8_t pattern_symbols[256]{};
+    size_t symbols = 1;
+    for (const auto &[pattern, group] : patterns)
+    {
+        if (pattern.empty() || group >= groups)
+        {
+            throw std::invalid_argument("Aho-Corasick patterns must be non-empty and belong to one of the groups");
+        }
+
+        // A boundary inside a pattern would let a match cross a lane cut in count()
+        for (size_t i = 1; i + 1 < pattern.size(); i++)
+        {
+            assert((uint8_t)pattern[i] != fold[boundary] && "boundary byte inside an Aho-Corasick pattern");
+        }
+
+        for (char c : pattern)
+        {
+            uint8_t byte = (uint8_t)c;
+            if (pattern_symbols[byte] == 0)
+            {
+                pattern_symbols[byte] = (uint8_t)symbols++;
+            }
+        }
+    }
+
+    for (int b = 0; b < 256; b++)
+    {
+        m_symbols[b] = pattern_symbols[fold[b]];
+    }
+
+    while (((size_t)1 << m_shift) < symbols + PACKED_SLOTS)
+    {
+        m_shift++;
+    }
+
+    // Trie of the patterns; -1 marks a missing edge until the DFA is completed
+    const size_t stride = (size_t)1 << m_shift;
+    std::vector<int32_t> trie(stride, -1);
+    std::vector<uint32_t> outputs(groups, 0);
+    for (const auto &[pattern, group] : patterns)
+    {
+        size_t state = 0;
+        for (char c : pattern)
+        {
+            size_t symbol = pattern_symbols[(uint8_t)c];
+            if (trie[state * stride + symbol] < 0)
+            {
+                trie[state * stride + symbol] = (int32_t)(trie.size() / stride);
+                trie.resize(trie.size() + stride, -1);
+                outputs.resize(outputs.size() + groups, 0);
+            }
+
+            state = trie[state * stride + symbol];
+        }
+
+        outputs[state * groups + group]++;
+    }
+
+    const size_t states = trie.size() / stride;
+    if (trie.size() > UINT16_MAX)
+    {
+        throw std::length_error("Too many Aho-Corasick states for 16 bit transitions");
+    }
+
+    // Breadth first, so a state's suffix link and its transitions are complete
+    // before the states below it need them. Transitions hold row offsets.
+    std::vector<uint32_t> fail(states, 0);
+    std::vector<uint32_t> queue{};
+    m_next.assign(states * stride, 0);
+    for (size_t symbol = 0; symbol < symbols; symbol++)
+    {
+        if (trie[symbol] > 0)
+        {
+            m_next[symbol] = (uint16_t)(trie[symbol] * stride);
+            queue.push_back(trie[symbol]);
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        uint32_t state = queue[head];
+        for (size_t g = 0; g < groups; g++)
+        {
+            outputs[state * groups + g] += outputs[fail[state] * groups + g];
+        }
+
+        for (size_t symbol = 0; symbol < symbols; symbol++)
+        {
+            int32_t child = trie[state * stride + symbol];
+            uint16_t fallback = m_next[fail[state] * stride + symbol];
+            if (child < 0)
+            {
+                m_next[state * stride + symbol] = fallback;
+            }
+            else
+            {
+                m_next[state * stride + symbol] = (uint16_t)(child * stride);
+                fail[child] = fallback / stride;
+                queue.push_back(child);
+            }
+        }
+    }
+
+    uint32_t most = 1;
+    for (size_t state = 0; state < states; state++)
+    {
+        uint64_t packed = 0;
+        for (size_t g = 0; g < groups; g++)
+        {
+            uint32_t count = outputs[state * groups + g];
+            if (count > PACKED_MASK)
+            {
+                throw std::length_error("Too many Aho-Corasick patterns end in one state");
+            }
+
+            most = std::max(most, count);
+            packed |= (uint64_t)count << (g * PACKED_BITS);
+        }
+
+        std::memcpy(&m_next[(state + 1) * stride - PACKED_SLOTS], &packed, sizeof(packed));
+    }
+
+    m_emissions = std::move(outputs);
+    m_flushBytes = PACKED_MASK / most;
+};
+
+void AhoCorasick::unpack(uint64_t packed, uint64_t *totals) const
+{
+    for (size_t g = 0; g < m_groups; g++)
+    {
+        totals[g] += (packed >> (g * PACKED_BITS)) & PACKED_MASK;
+    }
+};
+
+uint16_t AhoCorasick::scan(uint16_t state, const uint8_t *bytes, size_t length, uint64_t *totals) const
+{
+    const uint16_t *transitions = m_next.data();
+    const size_t stride = (size_t)1 << m_shift;
+    for (size_t i = 0; i < length;)
+    {
+        uint64_t hits = 0;
+        for (const size_t end = std::min(length, i + m_flushBytes); i < end; i++)
+        {
+            state = transitions[state + m_symbols[bytes[i]]];
+            hits += packedAt(transitions, stride, state);
+        }
+
+        unpack(hits, totals);
+    }
+
+    return state;
+};
+
+void AhoCorasick::count(const char *data, size_t length, uint32_t *counts) const
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    const uint8_t boundary = m_boundary;
+    const uint8_t boundary_symbol = m_symbols[boundary];
+
+    // Lane l scans [begin[l], begin[l + 1]); every lane but the first begins
+    // right after a boundary byte, which its predecessor still scans
+    size_t begin[SCAN_LANES + 1];
+    begin[0] = 0;
+    begin[SCAN_LANES] = length;
+    const size_t lanes = length < SCAN_LANES * MIN_LANE_BYTES ? 1 : SCAN_LANES;
+    for (size_t l = 1; l < SCAN_LANES; l++)
+    {
+        size_t cut = l < lanes ? std::max(length * l / lanes, begin[l - 1]) : length;
+        while (cut < length && m_symbols[bytes[cut]] != boundary_symbol)
+        {
+            cut++;
+        }
+
+        begin[l] = std::min(cut + 1, length);
+    }
+
+    uint16_t states[SCAN_LANES];
+    size_t common = length;
+    for (size_t l = 0; l < SCAN_LANES; l++)
+    {
+        states[l] = next(root(), boundary);
+        common = std::min(common, begin[l + 1] - begin[l]);
+    }
+
+    // Interleaved while every lane has bytes left: eight independent chains of
+    // transitions keep several loads in flight instead of waiting on each other.
+    // The lanes are spelled out so their states stay in registers; their hits
+    // share one accumulator, flushed SCAN_LANES times as often.
+    static_assert(SCAN_LANES == 8, "The interleaved loop is written for eight lanes");
+    uint64_t totals[MAX_PATTERN_GROUPS]{};
+    const uint16_t *transitions = m_next.data();
+    const uint8_t *symbols = m_symbols;
+    const size_t stride = (size_t)1 << m_shift;
+    const uint8_t *lane0 = bytes + begin[0], *lane1 = bytes + begin[1], *lane2 = bytes + begin[2], *lane3 = bytes + begin[3];
+    const uint8_t *lane4 = bytes + begin[4], *lane5 = bytes + begin[5], *lane6 = bytes + begin[6], *lane7 = bytes + begin[7];
+    size_t state0 = states[0], state1 = states[1], state2 = states[2], state3 = states[3];
+    size_t state4 = states[4], state5 = states[5], state6 = states[6], state7 = states[7];
+    const size_t flush = std::max<size_t>(m_flushBytes / SCAN_LANES, 1);
+    for (size_t i = 0; i < common;)
+    {
+        uint64_t hits = 0;
+        for (const size_t end = std::min(common, i + flush); i < end; i++)
+        {
+            state0 = transitions[state0 + symbols[lane0[i]]];
+            state1 = transitions[state1 + symbols[lane1[i]]];
+            state2 = transitions[state2 + symbols[lane2[i]]];
+            state3 = transitions[state3 + symbols[lane3[i]]];
+            state4 = transitions[state4 + symbols[lane4[i]]];
+            state5 = transitions[state5 + symbols[lane5[i]]];
+            state6 = transitions[state6 + symbols[lane6[i]]];
+            state7 = transitions[state7 + symbols[lane7[i]]];
+            hits += packedAt(transitions, stride, state0) + packedAt(transitions, stride, state1) +
+                    packedAt(transitions, stride, state2) + packedAt(transitions, stride, state3) +
+                    packedAt(transitions, stride, state4) + packedAt(transitions, stride, state5) +
+                    packedAt(transitions, stride, state6) + packedAt(transitions, stride, state7);
+        }
+
+        unpack(hits, totals);
+    }
+
+    states[0] = (uint16_t)state0;
+    states[1] = (uint16_t)state1;
+    states[2] = (uint16_t)state2;
+    states[3] = (uint16_t)state3;
+    states[4] = (uint16_t)state4;
+    states[5] = (uint16_t)state5;
+    states[6] = (uint16_t)state6;
+    states[7] = (uint16_t)state7;
+    for (size_t l = 0; l < SCAN_LANES; l++)
+    {
+        states[l] = scan(states[l], bytes + begin[l] + common, begin[l + 1] - begin[l] - common, totals);
+    }
+
+    // The closing boundary after the input, in the last lane that got any of it
+    size_t last = SCAN_LANES - 1;
+    while (last > 0 && begin[last] == begin[last + 1])
+    {
+        last--;
+    }
+
+    unpack(packedAt(transitions, stride, next(states[last], boundary)), totals);
+    for (size_t g = 0; g < m_groups; g++)
+    {
+        counts[g] += (uint32_t)totals[g];
+    }
+};
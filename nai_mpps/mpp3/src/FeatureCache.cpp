@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+#include "FeatureCache.h"
+
+// "MPP3FEAT" read as a little-endian integer; also rejects files of the other byte order
+#define CACHE_MAGIC 0x544145463350504Dull
+
+struct CacheHeader
+{
+    uint64_t Magic;
+    uint32_t Version;
+    uint32_t Letters;
+    uint32_t Buckets;
+    uint32_t MaxNGram;
+    uint64_t Entries;
+};
+
+static CacheHeader currentHeader(uint64_t entries)
+{
+    return {CACHE_MAGIC, CACHE_VERSION, FEATURES_COUNT, NGRAM_BUCKETS, MAX_NGRAM, entries};
+}
+
+template <typename T>
+static void read(std::istream &in, T &value)
+{
+    in.read((char *)&value, sizeof(value));
+}
+
+template <typename T>
+static void write(std::ostream &out, const T &value)
+{
+    out.write((const char *)&value, sizeof(value));
+}
+
+uint64_t contentHash(const char *data, size_t length)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ (uint8_t)data[i]) * 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+FeatureCache::FeatureCache(const std::string &path) : m_path(path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        return;
+    }
+
+    CacheHeader header{};
+    CacheHeader expected = currentHeader(0);
+    read(in, header);
+    if (!in || header.Magic != expected.Magic || header.Version != expected.Version ||
+        header.Letters != expected.Letters || header.Buckets != expected.Buckets || header.MaxNGram != expected.MaxNGram)
+    {
+        return;
+    }
+
+    for (uint64_t e = 0; e < header.Entries; e++)
+    {
+        uint32_t key_length = 0;
+        uint32_t ngrams = 0;
+        Entry entry{};
+        read(in, key_length);
+        if (!in || key_length > 4096)
+        {
+            break;
+        }
+
+        std::string key(key_length, '\0');
+        in.read(&key[0], key_length);
+        read(in, entry.Size);
+        read(in, entry.ModifiedTime);
+        read(in, entry.Hash);
+        in.read((char *)entry.Letters.data(), sizeof(entry.Letters));
+        read(in, ngrams);
+        if (!in || ngrams > NGRAM_BUCKETS)
+        {
+            break;
+        }
+
+        entry.NGrams.Indices.resize(ngrams);
+        entry.NGrams.Values.resize(ngrams);
+        in.read((char *)entry.NGrams.Indices.data(), ngrams * sizeof(uint32_t));
+        in.read((char *)entry.NGrams.Values.data(), ngrams * sizeof(float));
+        if (!in || std::any_of(entry.NGrams.Indices.begin(), entry.NGrams.Indices.end(), [](uint32_t index) { return index >= NGRAM_BUCKETS; }))
+        {
+            break;
+        }
+
+        m_entries[key] = std::move(entry);
+    }
+
+    // A truncated or damaged file is thrown away as a whole
+    if (m_entries.size() != header.Entries)
+    {
+        m_entries.clear();
+    }
+};
+
+const FeatureCache::Entry *FeatureCache::find(const std::string &key) const
+{
+    auto it = m_entries.find(key);
+    return it == m_entries.end() ? nullptr : &it->second;
+};
+
+void FeatureCache::store(const std::string &key, Entry entry)
+{
+    m_entries[key] = std::move(entry);
+};
+
+void FeatureCache::retain(const std::vector<std::string> &keys)
+{
+    std::unordered_set<std::string> kept(keys.begin(), keys.end());
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        it = kept.count(it->first) == 0 ? m_entries.erase(it) : std::next(it);
+    }
+};
+
+void FeatureCache::save() const
+{
+    const std::string temporary = m_path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        write(out, currentHeader(m_entries.size()));
+        for (const auto &[key, entry] : m_entries)
+        {
+            write(out, (uint32_t)key.size());
+            out.write(key.data(), key.size());
+            write(out, entry.Size);
+            write(out, entry.ModifiedTime);
+            write(out, entry.Hash);
+            out.write((const char *)entry.Letters.data(), sizeof(entry.Letters));
+            write(out, (uint32_t)entry.NGrams.Indices.size());
+            out.write((const char *)entry.NGrams.Indices.data(), entry.NGrams.Indices.size() * sizeof(uint32_t));
+            out.write((const char *)entry.NGrams.Values.data(), entry.NGrams.Values.size() * sizeof(float));
+        }
+
+        if (!out)
+        {
+            throw std::runtime_error("Cannot write " + temporary);
+        }
+    }
+
+    std::filesystem::rename(temporary, m_path);
+};
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include "AhoCorasick.h"
+#include "Features.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define DISCARD_BIN LETTERS_COUNT
+
+// Every letter of the alphabet beyond a-z: lower- and upper-case code point.
+// All of them lie in U+00C0..U+017F, i.e. they are two byte sequences
+// with a 0xC3..0xC5 lead byte.
+static const uint16_t DIACRITICS[LETTERS_COUNT - ASCII_LETTERS][2] = {
+    {0x0105, 0x0104}, // ą
+    {0x0107, 0x0106}, // ć
+    {0x0119, 0x0118}, // ę
+    {0x0142, 0x0141}, // ł
+    {0x0144, 0x0143}, // ń
+    {0x00F3, 0x00D3}, // ó
+    {0x015B, 0x015A}, // ś
+    {0x017A, 0x0179}, // ź
+    {0x017C, 0x017B}, // ż
+    {0x00E4, 0x00C4}, // ä
+    {0x00F6, 0x00D6}, // ö
+    {0x00FC, 0x00DC}, // ü
+    {0x00DF, 0x00DF}, // ß
+    {0x00E1, 0x00C1}, // á
+    {0x00E9, 0x00C9}, // é
+    {0x00ED, 0x00CD}, // í
+    {0x00F1, 0x00D1}, // ñ
+    {0x00FA, 0x00DA}, // ú
+};
+
+#define FIRST_LEAD 0xC3
+#define LAST_LEAD 0xC5
+
+// Case-folding tables into the alphabet index: Bins for single bytes, where
+// every byte >= 0x80 is discarded, and Latin for the byte that follows a
+// 0xC3..0xC5 lead byte (anything but a continuation byte is discarded there)
+struct LetterTable
+{
+    uint8_t Bins[256];
+    uint8_t Latin[LAST_LEAD - FIRST_LEAD + 1][256];
+
+    LetterTable()
+    {
+        std::fill(std::begin(Bins), std::end(Bins), (uint8_t)DISCARD_BIN);
+        for (int c = 0; c < ASCII_LETTERS; c++)
+        {
+            Bins['a' + c] = c;
+            Bins['A' + c] = c;
+        }
+
+        std::fill(&Latin[0][0], &Latin[0][0] + sizeof(Latin), (uint8_t)DISCARD_BIN);
+        for (int d = 0; d < LETTERS_COUNT - ASCII_LETTERS; d++)
+        {
+            for (uint16_t code_point : DIACRITICS[d])
+            {
+                Latin[(0xC0 | (code_point >> 6)) - FIRST_LEAD][0x80 | (code_point & 0x3F)] = ASCII_LETTERS + d;
+            }
+        }
+    };
+};
+
+static const LetterTable LETTER_TABLE{};
+
+uint32_t letterBin(uint8_t previous, uint8_t byte)
+{
+    if (byte >= 0x80 && previous >= FIRST_LEAD && previous <= LAST_LEAD)
+    {
+        return LETTER_TABLE.Latin[previous - FIRST_LEAD][byte];
+    }
+
+    return LETTER_TABLE.Bins[byte];
+}
+
+static uint32_t countTrailingZeros(uint64_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return index;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+#define BLOCK_BYTES 64
+
+// Bit b set when data[b] is a 0xC3..0xC5 lead byte, for the BLOCK_BYTES bytes at data
+static uint64_t leadMask(const uint8_t *data)
+{
+#if defined(_M_X64) || defined(__SSE2__)
+    // Bias to signed bytes so the unsigned range check becomes two signed compares
+    const __m128i bias = _mm_set1_epi8((char)0x80);
+    const __m128i first = _mm_set1_epi8((char)((FIRST_LEAD ^ 0x80) - 1));
+    const __m128i last = _mm_set1_epi8((char)((LAST_LEAD ^ 0x80) + 1));
+    uint64_t mask = 0;
+    for (uint32_t b = 0; b < BLOCK_BYTES; b += 16)
+    {
+        __m128i biased = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(data + b)), bias);
+        __m128i leads = _mm_and_si128(_mm_cmpgt_epi8(biased, first), _mm_cmplt_epi8(biased, last));
+        mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(leads) << b;
+    }
+
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (uint32_t b = 0; b < BLOCK_BYTES; b++)
+    {
+        mask |= (uint64_t)(data[b] >= FIRST_LEAD && data[b] <= LAST_LEAD) << b;
+    }
+
+    return mask;
+#endif
+}
+
+int Corpus::languageIndex(const std::string &language)
+{
+    auto it = std::find(Languages.begin(), Languages.end(), language);
+    if (it != Languages.end())
+    {
+        return std::distance(Languages.begin(), it);
+    }
+
+    Languages.push_back(language);
+    return Languages.size() - 1;
+}
+
+void getDistribution(const char *data, size_t length, Features &result)
+{
+    uint32_t occurrences[4][LETTERS_COUNT + 1]{};
+    const uint8_t *bytes = (const uint8_t *)data;
+    const uint8_t *bins = LETTER_TABLE.Bins;
+
+    // Every byte goes through the single byte table, which discards all of
+    // UTF-8's multi-byte sequences. The alphabet's two byte letters are then
+    // added back from the lead bytes the SIMD mask finds in each block.
+    const auto &latin = LETTER_TABLE.Latin;
+    size_t i = 0;
+    // Strictly less, so the byte after a lead byte is always in range
+    for (; i + BLOCK_BYTES < length; i += BLOCK_BYTES)
+    {
+        for (size_t b = i; b < i + BLOCK_BYTES; b += 4)
+        {
+            occurrences[0][bins[bytes[b]]]++;
+            occurrences[1][bins[bytes[b + 1]]]++;
+            occurrences[2][bins[bytes[b + 2]]]++;
+            occurrences[3][bins[bytes[b + 3]]]++;
+        }
+
+        for (uint64_t leads = leadMask(bytes + i); leads != 0; leads &= leads - 1)
+        {
+            size_t lead = i + countTrailingZeros(leads);
+            occurrences[1][latin[bytes[lead] - FIRST_LEAD][bytes[lead + 1]]]++;
+        }
+    }
+
+    for (; i < length; i++)
+    {
+        occurrences[0][bins[bytes[i]]]++;
+        if (bytes[i] >= FIRST_LEAD && bytes[i] <= LAST_LEAD && i + 1 < length)
+        {
+            occurrences[1][latin[bytes[i] - FIRST_LEAD][bytes[i + 1]]]++;
+        }
+    }
+
+    uint32_t num_of_chars = 0;
+    uint32_t counts[LETTERS_COUNT];
+    for (size_t c = 0; c < LETTERS_COUNT; c++)
+    {
+        counts[c] = occurrences[0][c] + occurrences[1][c] + occurrences[2][c] + occurrences[3][c];
+        num_of_chars += counts[c];
+    }
+
+    // A document without letters gets an all-zero distribution instead of NaNs
+    float norm_coef = num_of_chars == 0 ? 0.0f : 1.0f / num_of_chars;
+    for (size_t c = 0; c < LETTERS_COUNT; c++)
+    {
+        result[c] = counts[c] * norm_coef;
+    }
+}
+
+void getDistribution(const std::string &str, Features &result)
+{
+    getDistribution(str.data(), str.size(), result);
+}
+
+struct FoldTable
+{
+    uint8_t Bytes[256];
+
+    FoldTable()
+    {
+        for (int b = 0; b < 256; b++)
+        {
+            Bytes[b] = b >= 0x80 ? b : ' ';
+        }
+
+        for (int c = 0; c < ASCII_LETTERS; c++)
+        {
+            Bytes['a' + c] = 'a' + c;
+            Bytes['A' + c] = 'a' + c;
+        }
+    };
+};
+
+static const FoldTable FOLD_TABLE{};
+
+uint8_t foldByte(uint8_t byte)
+{
+    return FOLD_TABLE.Bytes[byte];
+}
+
+uint32_t ngramBucket(uint32_t window, uint32_t n)
+{
+    static const uint32_t masks[MAX_NGRAM + 1] = {0, 0xFFu, 0xFFFFu, 0xFFFFFFu, 0xFFFFFFFFu};
+    uint64_t key = ((uint64_t)n << 32) | (window & masks[n]);
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> (64 - NGRAM_BITS));
+}
+
+void getNGrams(const char *data, size_t length, SparseFeatures &result)
+{
+    // Per-thread bucket counts; only the touched buckets are read back and reset
+    thread_local std::vector<uint32_t> counts(NGRAM_BUCKETS, 0);
+    thread_local std::vector<uint32_t> touched{};
+    touched.clear();
+
+    const uint8_t *bytes = (const uint8_t *)data;
+    const uint8_t *fold = FOLD_TABLE.Bytes;
+    uint32_t window = ' ';
+    uint32_t filled = 1;
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t byte = fold[bytes[i]];
+        if (byte == ' ' && (window & 0xFFu) == ' ')
+        {
+            continue;
+        }
+
+        window = (window << 8) | byte;
+        filled = std::min<uint32_t>(filled + 1, MAX_NGRAM);
+        for (uint32_t n = 1; n <= filled; n++)
+        {
+            uint32_t bucket = ngramBucket(window, n);
+            if (counts[bucket]++ == 0)
+            {
+                touched.push_back(bucket);
+            }
+        }
+    }
+
+    result.Indices.assign(touched.begin(), touched.end());
+    result.Values.resize(touched.size());
+    // Unit length rather than unit sum: spread over hundreds of buckets, plain
+    // frequencies are too small to move the perceptron against the letter features
+    double squares = 0.0;
+    for (size_t t = 0; t < touched.size(); t++)
+    {
+        squares += (double)counts[touched[t]] * counts[touched[t]];
+    }
+
+    float norm_coef = squares == 0.0 ? 0.0f : (float)(1.0 / std::sqrt(squares));
+    for (size_t t = 0; t < touched.size(); t++)
+    {
+        result.Values[t] = counts[touched[t]] * norm_coef;
+        counts[touched[t]] = 0;
+    }
+}
+
+void getNGrams(const std::string &str, SparseFeatures &result)
+{
+    getNGrams(str.data(), str.size(), result);
+}
+
+// Most frequent short words of each language; a word may be on several lists.
+// Patterns are enclosed in spaces, which the folding makes of every non-letter.
+static const char *const FUNCTION_WORDS[FUNCTION_WORD_LISTS] = {
+    // de
+    "der die das und ist nicht ein eine einen zu den von mit sich des auf f\xC3\xBCr im dem "
+    "auch es an als wird sind oder bei nach aus wie wir ich sie er hat",
+    // en
+    "the of and to in is that it was for on are with as be by this from or which "
+    "an not have has were his they at but he she you we",
+    // es
+    "el la los las de que y en un una es por con para del se no al lo como m\xC3\xA1s "
+    "su sus fue son pero entre est\xC3\xA1 muy ya hay",
+    // pl
+    "i w na z si\xC4\x99 nie do to \xC5\xBC" "e jest o jak po od przez oraz jego co ich tak "
+    "by\xC4\x87 jako ale dla s\xC4\x85 kt\xC3\xB3ry kt\xC3\xB3ra kt\xC3\xB3re ze czy",
+};
+
+static std::vector<std::pair<std::string, uint32_t>> functionWordPatterns()
+{
+    std::vector<std::pair<std::string, uint32_t>> patterns{};
+    for (uint32_t list = 0; list < FUNCTION_WORD_LISTS; list++)
+    {
+        std::istringstream words(FUNCTION_WORDS[list]);
+        std::string word;
+        while (words >> word)
+        {
+            patterns.emplace_back(' ' + word + ' ', list);
+        }
+    }
+
+    return patterns;
+}
+
+const AhoCorasick &functionWords()
+{
+    static const AhoCorasick automaton(functionWordPatterns(), FUNCTION_WORD_LISTS, FOLD_TABLE.Bytes, ' ');
+    return automaton;
+}
+
+void getFunctionWords(const char *data, size_t length, Features &result)
+{
+    uint32_t hits[FUNCTION_WORD_LISTS]{};
+    functionWords().count(data, length, hits);
+
+    uint32_t total = 0;
+    for (uint32_t list = 0; list < FUNCTION_WORD_LISTS; list++)
+    {
+        total += hits[list];
+    }
+
+    float norm_coef = total == 0 ? 0.0f : 1.0f / total;
+    for (uint32_t list = 0; list < FUNCTION_WORD_LISTS; list++)
+    {
+        result[LETTERS_COUNT + list] = hits[list] * norm_coef;
+    }
+}
+
+void getFunctionWords(const std::string &str, Features &result)
+{
+    getFunctionWords(str.data(), str.size(), result);
+}
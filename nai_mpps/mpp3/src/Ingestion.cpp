@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <filesystem>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include "Ingestion.h"
+#include "FeatureCache.h"
+#include "MappedFile.h"
+
+namespace fs = std::filesystem;
+
+static std::vector<fs::path> sortedEntries(const fs::path &path)
+{
+    std::vector<fs::path> entries{};
+    for (const auto &dir_entry : fs::directory_iterator(path))
+    {
+        entries.push_back(dir_entry.path());
+    }
+
+    std::sort(entries.begin(), entries.end());
+    return entries;
+}
+
+void parse(const std::string &path, Corpus &result, ThreadPool &pool)
+{
+    std::vector<fs::path> files{};
+    const size_t first = result.Documents.size();
+    for (const fs::path &language_path : sortedEntries(path))
+    {
+        int label = result.languageIndex(language_path.filename().string());
+        std::vector<fs::path> language_files = sortedEntries(language_path);
+        result.Labels.insert(result.Labels.end(), language_files.size(), label);
+        files.insert(files.end(), language_files.begin(), language_files.end());
+    }
+
+    result.Documents.resize(first + files.size());
+    result.NGrams.resize(first + files.size());
+
+    FeatureCache cache(path + CACHE_EXTENSION);
+    std::vector<std::string> keys(files.size());
+    std::vector<FeatureCache::Entry> updates(files.size());
+    std::vector<uint8_t> changed(files.size(), 0);
+    for (size_t f = 0; f < files.size(); f++)
+    {
+        keys[f] = files[f].lexically_relative(path).generic_string();
+    }
+
+    std::mutex error_mutex;
+    std::exception_ptr error = nullptr;
+    for (size_t begin = 0; begin < files.size(); begin += INGEST_BATCH)
+    {
+        const size_t end = std::min(begin + INGEST_BATCH, files.size());
+        pool.submit([&, begin, end]() {
+            try
+            {
+                for (size_t f = begin; f < end; f++)
+                {
+                    Features &letters = result.Documents[first + f];
+                    SparseFeatures &ngrams = result.NGrams[first + f];
+                    FeatureCache::Entry &update = updates[f];
+                    update.Size = fs::file_size(files[f]);
+                    update.ModifiedTime = fs::last_write_time(files[f]).time_since_epoch().count();
+
+                    const FeatureCache::Entry *cached = cache.find(keys[f]);
+                    if (cached != nullptr && cached->Size == update.Size && cached->ModifiedTime == update.ModifiedTime)
+                    {
+                        letters = cached->Letters;
+                        ngrams = cached->NGrams;
+                        continue;
+                    }
+
+                    MappedFile file(files[f]);
+                    update.Size = file.size();
+                    update.Hash = contentHash(file.data(), file.size());
+                    if (cached != nullptr && cached->Size == update.Size && cached->Hash == update.Hash)
+                    {
+                        letters = cached->Letters;
+                        ngrams = cached->NGrams;
+                    }
+                    else
+                    {
+                        getDistribution(file.data(), file.size(), letters);
+                        getFunctionWords(file.data(), file.size(), letters);
+                        getNGrams(file.data(), file.size(), ngrams);
+                    }
+
+                    changed[f] = 1;
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (error == nullptr)
+                {
+                    error = std::current_exception();
+                }
+            }
+        });
+    }
+
+    pool.wait();
+    if (error != nullptr)
+    {
+        std::rethrow_exception(error);
+    }
+
+    // Lookups above are concurrent reads, so the cache is only updated now
+    const size_t cached_before = cache.size();
+    size_t changes = 0;
+    for (size_t f = 0; f < files.size(); f++)
+    {
+        if (changed[f])
+        {
+            updates[f].Letters = result.Documents[first + f];
+            updates[f].NGrams = result.NGrams[first + f];
+            cache.store(keys[f], std::move(updates[f]));
+            changes++;
+        }
+    }
+
+    cache.retain(keys);
+    if (changes == 0 && cache.size() == cached_before)
+    {
+        return;
+    }
+
+    try
+    {
+        cache.save();
+    }
+    catch (const std::exception &e)
+    {
+        // Only the next start gets slower
+        std::cerr << "Feature cache not saved: " << e.what() << std::endl;
+    }
+}
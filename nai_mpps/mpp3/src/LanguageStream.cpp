@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include "AhoCorasick.h"
+#include "LanguageStream.h"
+
+static_assert(NGRAM_BUCKETS <= 65536, "Contribution stores n-gram buckets in 16 bits");
+
+LanguageStream::LanguageStream(const std::vector<Perceptron> &perceptrons, size_t window)
+    : m_perceptrons(perceptrons),
+      m_languages(perceptrons.size()),
+      m_window(window),
+      m_ring(window),
+      m_ngramCounts(NGRAM_BUCKETS, 0),
+      m_letterDots(perceptrons.size(), 0.0),
+      m_ngramDots(perceptrons.size(), 0.0),
+      m_wordDots(perceptrons.size(), 0.0),
+      m_wordState(functionWords().next(functionWords().root(), functionWords().boundary()))
+{
+    if (window == 0 || perceptrons.empty())
+    {
+        throw std::logic_error("Language stream needs a window and at least one perceptron");
+    }
+
+    // Feature-major copy of the effective weights: one feature's weights for
+    // all languages share a cache line
+    const size_t features = FEATURES_COUNT + NGRAM_BUCKETS;
+    m_weights.resize(features * m_languages);
+    for (size_t k = 0; k < m_languages; k++)
+    {
+        for (size_t j = 0; j < features; j++)
+        {
+            m_weights[j * m_languages + k] = perceptrons[k].Weights[j] * perceptrons[k].Scale;
+        }
+    }
+};
+
+void LanguageStream::countWords(uint16_t state, int sign)
+{
+    const uint32_t *hits = functionWords().emission(state);
+    if (hits == nullptr)
+    {
+        return;
+    }
+
+    for (size_t list = 0; list < FUNCTION_WORD_LISTS; list++)
+    {
+        m_wordHits += sign * (int64_t)hits[list];
+        const float *weights = m_weights.data() + (LETTERS_COUNT + list) * m_languages;
+        for (size_t k = 0; k < m_languages; k++)
+        {
+            m_wordDots[k] += sign * (double)hits[list] * weights[k];
+        }
+    }
+};
+
+void LanguageStream::add(uint8_t byte, Contribution &contribution)
+{
+    m_wordState = functionWords().next(m_wordState, byte);
+    contribution.WordState = m_wordState;
+    countWords(m_wordState, 1);
+
+    contribution.Letter = letterBin(m_previous, byte);
+    m_previous = byte;
+    if (contribution.Letter != LETTERS_COUNT)
+    {
+        m_letters++;
+        const float *weights = m_weights.data() + contribution.Letter * m_languages;
+        for (size_t k = 0; k < m_languages; k++)
+        {
+            m_letterDots[k] += weights[k];
+        }
+    }
+
+    // Same folding as getNGrams: runs of non-letters collapse into one space
+    contribution.NGrams = 0;
+    uint8_t folded = foldByte(byte);
+    if (folded == ' ' && (m_ngramWindow & 0xFFu) == ' ')
+    {
+        return;
+    }
+
+    m_ngramWindow = (m_ngramWindow << 8) | folded;
+    m_filled = std::min<uint32_t>(m_filled + 1, MAX_NGRAM);
+    for (uint32_t n = 1; n <= m_filled; n++)
+    {
+        uint32_t bucket = ngramBucket(m_ngramWindow, n);
+        // (c + 1)^2 - c^2 keeps the sum of squared counts current
+        m_squares += 2 * m_ngramCounts[bucket]++ + 1;
+        const float *weights = m_weights.data() + (FEATURES_COUNT + bucket) * m_languages;
+        for (size_t k = 0; k < m_languages; k++)
+        {
+            m_ngramDots[k] += weights[k];
+        }
+
+        contribution.Buckets[contribution.NGrams++] = bucket;
+    }
+};
+
+void LanguageStream::remove(const Contribution &contribution)
+{
+    countWords(contribution.WordState, -1);
+
+    if (contribution.Letter != LETTERS_COUNT)
+    {
+        m_letters--;
+        const float *weights = m_weights.data() + contribution.Letter * m_languages;
+        for (size_t k = 0; k < m_languages; k++)
+        {
+            m_letterDots[k] -= weights[k];
+        }
+    }
+
+    for (uint32_t n = 0; n < contribution.NGrams; n++)
+    {
+        uint32_t bucket = contribution.Buckets[n];
+        m_squares -= 2 * m_ngramCounts[bucket]-- - 1;
+        const float *weights = m_weights.data() + (FEATURES_COUNT + bucket) * m_languages;
+        for (size_t k = 0; k < m_languages; k++)
+        {
+            m_ngramDots[k] -= weights[k];
+        }
+    }
+};
+
+size_t LanguageStream::classify() const
+{
+    // The same net as Perceptron::predict on the window's getDistribution, getFunctionWords and getNGrams
+    double letter_coef = m_letters == 0 ? 0.0 : 1.0 / m_letters;
+    double ngram_coef = m_squares == 0 ? 0.0 : 1.0 / std::sqrt((double)m_squares);
+    double word_coef = m_wordHits == 0 ? 0.0 : 1.0 / m_wordHits;
+
+    size_t best = 0;
+    double best_net = 0.0;
+    for (size_t k = 0; k < m_languages; k++)
+    {
+        double net = m_letterDots[k] * letter_coef + m_ngramDots[k] * ngram_coef + m_wordDots[k] * word_coef - m_perceptrons[k].Threshold;
+        if (k == 0 || net > best_net)
+        {
+            best_net = net;
+            best = k;
+        }
+    }
+
+    return best;
+};
+
+void LanguageStream::decide(size_t center, std::vector<LanguageSpan> &spans)
+{
+    size_t language = classify();
+    if (m_language == SIZE_MAX)
+    {
+        m_language = language;
+    }
+    else if (language != m_language)
+    {
+        spans.push_back({m_spanBegin, center, m_language});
+        m_spanBegin = center;
+        m_language = language;
+    }
+};
+
+void LanguageStream::feed(const char *data, size_t length, std::vector<LanguageSpan> &spans)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < length; i++)
+    {
+        Contribution &slot = m_ring[m_position % m_window];
+        if (m_position >= m_window)
+        {
+            remove(slot);
+        }
+
+        add(bytes[i], slot);
+        m_position++;
+        if (m_position >= m_window)
+        {
+            decide(m_position - m_window / 2, spans);
+        }
+    }
+};
+
+void LanguageStream::finish(std::vector<LanguageSpan> &spans)
+{
+    if (m_position == 0)
+    {
+        return;
+    }
+
+    // Input shorter than the window: one decision over all of it
+    if (m_language == SIZE_MAX)
+    {
+        m_language = classify();
+    }
+
+    spans.push_back({m_spanBegin, m_position, m_language});
+    m_spanBegin = m_position;
+};
+
+void printLanguageSpans(std::FILE *file, const std::vector<Perceptron> &perceptrons, size_t window)
+{
+    LanguageStream stream(perceptrons, window);
+    std::vector<char> buffer(STREAM_BUFFER);
+    std::vector<LanguageSpan> spans{};
+    while (true)
+    {
+        size_t read = std::fread(buffer.data(), 1, buffer.size(), file);
+        if (read == 0)
+        {
+            stream.finish(spans);
+        }
+        else
+        {
+            stream.feed(buffer.data(), read, spans);
+        }
+
+        for (const LanguageSpan &span : spans)
+        {
+            std::cout << span.Begin << " " << span.End << " " << perceptrons[span.Language].Label << '\n';
+        }
+
+        spans.clear();
+        if (read == 0)
+        {
+            break;
+        }
+    }
+};
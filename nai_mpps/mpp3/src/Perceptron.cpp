@@ -0,0 +1,81 @@
+#include <cmath>
+#include "Perceptron.h"
+
+float dot(const float *v1, const float *v2, size_t size)
+{
+    float result = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        result += v1[i] * v2[i];
+    }
+
+    return result;
+}
+
+float Perceptron::predict(const Sample &input) const
+{
+    const float *ngram_weights = Weights.data() + FEATURES_COUNT;
+    float net = dot(input.Letters, Weights.data(), FEATURES_COUNT);
+    for (size_t i = 0; i < input.NGrams; i++)
+    {
+        net += input.Values[i] * ngram_weights[input.Indices[i]];
+    }
+
+    return net * Scale - Threshold;
+}
+
+void Perceptron::deltaRule(const Sample &input, float desired, float output)
+{
+    float error = desired - output;
+    float step = error * ALPHA / Scale;
+    float *ngram_weights = Weights.data() + FEATURES_COUNT;
+    for (size_t i = 0; i < FEATURES_COUNT; i++)
+    {
+        Weights[i] += step * input.Letters[i];
+        WeightSum += step * input.Letters[i];
+    }
+
+    for (size_t i = 0; i < input.NGrams; i++)
+    {
+        ngram_weights[input.Indices[i]] += step * input.Values[i];
+        WeightSum += step * input.Values[i];
+    }
+
+    Threshold += error * ALPHA * (-1.0f);
+    normalize();
+};
+
+void Perceptron::normalize()
+{
+    // Effective weights sum to 1 afterwards, as if each one were divided by their sum
+    Scale = 1.0f / WeightSum;
+    if (std::abs(Scale) > MAX_SCALE || std::abs(Scale) < 1.0f / MAX_SCALE)
+    {
+        // Fold the scale back in before it over- or underflows, dropping the running sum's drift
+        WeightSum = 0.0f;
+        for (float &weight : Weights)
+        {
+            weight *= Scale;
+            WeightSum += weight;
+        }
+
+        Scale = 1.0f / WeightSum;
+    }
+};
+
+size_t answer(const Sample &input, const std::vector<Perceptron> &perceptrons)
+{
+    size_t best = 0;
+    float best_net = perceptrons[0].predict(input);
+    for (size_t w = 1; w < perceptrons.size(); w++)
+    {
+        float net = perceptrons[w].predict(input);
+        if (net > best_net)
+        {
+            best_net = net;
+            best = w;
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,92 @@
+#include <chrono>
+#include <cmath>
+#include "Training.h"
+
+TrainingMatrix::TrainingMatrix(const Corpus &corpus)
+    : Rows(corpus.Documents.size()),
+      Letters(Rows * FEATURES_COUNT),
+      Offsets(Rows + 1, 0),
+      Labels(corpus.Labels)
+{
+    for (size_t r = 0; r < Rows; r++)
+    {
+        Offsets[r + 1] = Offsets[r] + corpus.NGrams[r].Indices.size();
+    }
+
+    Indices.reserve(Offsets[Rows]);
+    Values.reserve(Offsets[Rows]);
+    for (size_t r = 0; r < Rows; r++)
+    {
+        std::copy(corpus.Documents[r].begin(), corpus.Documents[r].end(), Letters.begin() + r * FEATURES_COUNT);
+        Indices.insert(Indices.end(), corpus.NGrams[r].Indices.begin(), corpus.NGrams[r].Indices.end());
+        Values.insert(Values.end(), corpus.NGrams[r].Values.begin(), corpus.NGrams[r].Values.end());
+    }
+};
+
+float evaluate(const TrainingMatrix &matrix, const std::vector<Perceptron> &perceptrons, std::vector<int> *predictions)
+{
+    if (predictions != nullptr)
+    {
+        predictions->resize(matrix.Rows);
+    }
+
+    size_t correct = 0;
+    for (size_t r = 0; r < matrix.Rows; r++)
+    {
+        int best = (int)answer(matrix.row(r), perceptrons);
+        correct += best == matrix.Labels[r];
+        if (predictions != nullptr)
+        {
+            (*predictions)[r] = best;
+        }
+    }
+
+    return matrix.Rows == 0 ? 0.0f : (float)correct / matrix.Rows * 100.0f;
+}
+
+void trainEpoch(const TrainingMatrix &matrix, std::vector<Perceptron> &perceptrons)
+{
+    for (size_t r = 0; r < matrix.Rows; r++)
+    {
+        Sample input = matrix.row(r);
+        for (size_t i = 0; i < perceptrons.size(); i++)
+        {
+            float output = perceptrons[i].predict(input);
+            float desired = (int)i == matrix.Labels[r] ? 1.0f : 0.0f;
+            perceptrons[i].deltaRule(input, desired, output);
+        }
+    }
+}
+
+TrainingResult train(const TrainingMatrix &train_data, const TrainingMatrix &test_data, std::vector<Perceptron> &perceptrons,
+                     float tolerance, size_t max_epochs, double max_seconds)
+{
+    const auto start = std::chrono::steady_clock::now();
+    TrainingResult result{};
+    std::vector<Perceptron> best = perceptrons;
+    float best_accuracy = -1.0f;
+    while (result.Epochs < max_epochs && result.Seconds < max_seconds)
+    {
+        trainEpoch(train_data, perceptrons);
+        result.Epochs++;
+        result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        float accuracy = evaluate(test_data, perceptrons);
+        if (accuracy > best_accuracy)
+        {
+            best_accuracy = accuracy;
+            result.BestEpoch = result.Epochs;
+            best = perceptrons;
+        }
+
+        if (std::abs(100 - accuracy) <= tolerance)
+        {
+            result.Converged = true;
+            break;
+        }
+    }
+
+    perceptrons = std::move(best);
+    result.Accuracy = std::max(best_accuracy, 0.0f);
+    return result;
+}
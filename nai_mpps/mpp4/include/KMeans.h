@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Random.h"
+#include "ThreadPool.h"
+
+// Chunks of points per pool thread, so threads that skip more points in the
+// bounded variants pick up the chunks of those that skip fewer
+#define CHUNKS_PER_THREAD 4
+// Points below which a chunk is not worth a job of its own
+#define MIN_CHUNK_POINTS 1024
+
+struct Point
+{
+    std::vector<double> Coordinates{};
+    std::string DecisionAttribute{};
+};
+
+// The K centroids stored dimension by dimension: coordinate d of centroid c
+// is Coordinates[d * K + c]. One point's distances to all centroids then
+// sweep each dimension across the centroids in a contiguous, vectorizable
+// loop. Clusters themselves are only the label array of the points.
+struct Centroids
+{
+    size_t K = 0;
+    size_t Dimensions = 0;
+    std::vector<double> Coordinates{};
+
+    Centroids(size_t k, size_t dimensions) : K(k), Dimensions(dimensions), Coordinates(k * dimensions, 0.0) {};
+
+    double at(size_t c, size_t d) const { return Coordinates[d * K + c]; };
+    // Centroid c becomes a copy of the point
+    void set(size_t c, const Point &point);
+    double distanceSquare(const Point &point, size_t c) const;
+    // Squared distances of the point to every centroid into distances[0..K)
+    void distancesSquare(const Point &point, double *distances) const;
+};
+
+// Per-cluster totals of one pass over the labels
+struct ClusterTotals
+{
+    // K x dimensions sums of the members' coordinates
+    std::vector<double> Sums{};
+    std::vector<size_t> Counts{};
+    // Sums of the members' squared distances to the centroids of the pass
+    std::vector<double> Distances{};
+
+    // Mean of every cluster, DBL_MAX coordinates for an empty one
+    void means(Centroids &centroids) const;
+};
+
+double distanceSquare(const Point &a, const Point &b);
+// Entropy of the decision attribute distribution given by its counts over total points
+double entropy(const std::unordered_map<std::string, int> &occurances, size_t total);
+// Entropy of the decision attribute within each of the k clusters of the labels
+std::vector<double> clusterEntropies(const std::vector<Point> &points, const std::vector<int> &labels, size_t k);
+
+// Initial partitions as one cluster label per point
+int initializeClustersRandomly(int k, const std::vector<Point> &points, std::vector<int> &labels, Random &random);
+// seeds, when given, receives the index of every cluster's seed point
+int initializeClustersPlusPlus(int k, const std::vector<Point> &points, std::vector<int> &labels, Random &random, std::vector<size_t> *seeds = nullptr);
+
+// How each iteration finds the nearest centroid of every point. All of them
+// produce Lloyd's assignment (up to ties); Hamerly and Elkan keep bounds that
+// let them skip most of the point to centroid distances.
+enum class Variant
+{
+    Lloyd,
+    Hamerly,
+    Elkan
+};
+
+// Throws std::invalid_argument for an unknown name
+Variant parseVariant(const std::string &name);
+const char *variantName(Variant variant);
+
+struct AssignmentStats
+{
+    // Distances computed, centroid to centroid ones included
+    uint64_t Evaluations = 0;
+    // Point to centroid distances Lloyd's N x K scan would have computed on top
+    int64_t Avoided = 0;
+    // Points whose label changed; none means k-means has converged
+    size_t Changes = 0;
+};
+
+// Assignment step of k-means over a fixed set of points. The accelerated
+// variants rely on the triangle inequality with exact (not squared) distances:
+//  - Hamerly keeps per point an upper bound on the distance to its own
+//    centroid and one lower bound on the distance to every other centroid.
+//    A point whose upper bound is below both that lower bound and half the
+//    distance from its centroid to the nearest other centroid cannot change
+//    clusters and is skipped.
+//  - Elkan keeps a lower bound per point and centroid, so it can also skip
+//    single centroids; it wins when K is large.
+// Between iterations every bound moves by how far the centroids moved.
+//
+// Given a pool, the points are cut into chunks that are assigned and reduced
+// in parallel. Points only ever write their own label and bounds, and every
+// chunk adds up its statistics and cluster totals in its own accumulators,
+// which are merged once per pass, so the loops neither lock nor allocate.
+class Assignment
+{
+private:
+    // Accumulators of one chunk of points
+    struct Partial
+    {
+        size_t Begin = 0;
+        size_t End = 0;
+        AssignmentStats Stats{};
+        ClusterTotals Totals{};
+        // One point's distances to all centroids
+        std::vector<double> Distances{};
+    };
+
+    const std::vector<Point> &m_points;
+    size_t m_k;
+    Variant m_variant;
+    ThreadPool *m_pool;
+    std::vector<Partial> m_partials;
+    std::vector<int> m_labels;
+    Centroids m_centroids;
+    // Upper bound on the distance from each point to its centroid
+    std::vector<double> m_upper;
+    // Hamerly: one lower bound per point, Elkan: one per point and centroid
+    std::vector<double> m_lower;
+    // Elkan: whether the upper bound may be loose
+    std::vector<uint8_t> m_stale;
+    // Distances between all pairs of centroids and half of each centroid's nearest one
+    std::vector<double> m_centroidDistances;
+    std::vector<double> m_halfNearest;
+    bool m_bounded = false;
+
+    double distance(size_t point, size_t centroid) const;
+    // Runs job on every chunk, on the pool if there is one, and returns when all are done
+    void forEachChunk(const std::function<void(Partial &)> &job);
+    // Moves the bounds by each centroid's drift and keeps the new centroids
+    void moveCentroids(const Centroids &centroids, AssignmentStats &stats);
+    void computeCentroidDistances(AssignmentStats &stats);
+    // Exact nearest and second nearest centroid of one point, refreshing its bounds
+    void assignExactly(size_t point, Partial &partial);
+    void updateLloyd(Partial &partial);
+    void updateHamerly(Partial &partial);
+    void updateElkan(Partial &partial);
+
+public:
+    // Without a pool everything runs on the calling thread
+    Assignment(const std::vector<Point> &points, size_t k, Variant variant, const std::vector<int> &labels, ThreadPool *pool = nullptr);
+    Assignment() = delete;
+    Assignment(const Assignment &other) = delete;
+    Assignment &operator=(const Assignment &other) = delete;
+    Assignment(Assignment &&) = delete;
+    Assignment &operator=(Assignment &&) = delete;
+    ~Assignment() = default;
+
+    // Labels every point with its nearest centroid
+    AssignmentStats update(const Centroids &centroids);
+    // Each empty cluster takes over the point farthest from its centroid, which
+    // becomes the cluster's centroid; returns how many were reseeded
+    int reseedEmptyClusters(Centroids &centroids);
+    // Cluster totals of the current labels; the distances are measured to
+    // centroids unless it is null
+    void reduce(const Centroids *centroids, ClusterTotals &totals);
+    const std::vector<int> &labels() const { return m_labels; };
+};
+
+// Outcome of one k-means run
+struct KMeansResult
+{
+    std::vector<int> Labels{};
+    // Totals of the final labels, distances measured to the final centroids
+    ClusterTotals Totals{};
+    double SSE = 0;
+    int Iterations = 0;
+    uint64_t Evaluations = 0;
+    int64_t Avoided = 0;
+    double Seconds = 0;
+};
+
+// Lloyd's loop from the initial labels until an iteration changes none. Only
+// reads the points, so runs on the same points may go on concurrently. With
+// a log every iteration's label changes, distance evaluations and per-cluster
+// sums are printed to it.
+KMeansResult runKMeans(const std::vector<Point> &points, int k, Variant variant, const std::vector<int> &labels, ThreadPool *pool, std::ostream *log);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "KMeans.h"
+#include "Random.h"
+
+// Passes over the data file unless "--passes P" says otherwise
+#define MINIBATCH_PASSES 3
+// Runs of consecutive lines a sampled batch is made of
+#define MINIBATCH_RUNS 16
+
+// Points of a data file in the training file's format (whitespace separated
+// coordinates, decision attribute last), read a batch at a time so only one
+// batch is resident however large the file is
+class PointReader
+{
+private:
+    std::string m_path;
+    std::ifstream m_file;
+    std::string m_line;
+    std::vector<std::pair<size_t, size_t>> m_words;
+    size_t m_dimensions = 0;
+    uint64_t m_size = 0;
+
+    // Parses m_line into row `slot`; false for a blank line
+    bool parse(size_t slot, std::vector<double> &coordinates, std::vector<std::string> &attributes);
+
+public:
+    // Takes the number of coordinates from the first line
+    explicit PointReader(const std::string &path);
+    PointReader() = delete;
+    PointReader(const PointReader &other) = delete;
+    PointReader &operator=(const PointReader &other) = delete;
+    PointReader(PointReader &&) = delete;
+    PointReader &operator=(PointReader &&) = delete;
+    ~PointReader() = default;
+
+    size_t dimensions() const { return m_dimensions; };
+    uint64_t size() const { return m_size; };
+    // Bytes read so far by read, the whole file once it hit the end
+    uint64_t position();
+
+    // Replaces coordinates (count x dimensions, row-major) and attributes with
+    // the next up to count points; returns how many were read, 0 at the end
+    size_t read(size_t count, std::vector<double> &coordinates, std::vector<std::string> &attributes);
+    // Like read, but the count points come from `runs` runs of consecutive
+    // lines that start at random offsets, wrapping around at the end. A file
+    // sorted by class thus still yields mixed batches at a few seeks per batch.
+    void sample(size_t count, size_t runs, std::vector<double> &coordinates, std::vector<std::string> &attributes, Random &random);
+    void rewind();
+};
+
+// Mini-batch k-means (Sculley, "Web-scale k-means clustering"). Every batch is
+// assigned to the current centroids, then each of its points pulls its
+// centroid towards itself with the centroid's own learning rate 1/n, where n
+// counts the points the centroid has taken so far. A centroid thus stays the
+// running mean of its points and settles as it gathers them.
+class MiniBatchKMeans
+{
+private:
+    size_t m_k;
+    size_t m_dimensions;
+    std::vector<double> m_centroids;
+    std::vector<uint64_t> m_counts;
+    std::vector<int> m_labels;
+
+public:
+    MiniBatchKMeans(size_t k, size_t dimensions);
+    MiniBatchKMeans() = delete;
+    MiniBatchKMeans(const MiniBatchKMeans &other) = delete;
+    MiniBatchKMeans &operator=(const MiniBatchKMeans &other) = delete;
+    MiniBatchKMeans(MiniBatchKMeans &&) = delete;
+    MiniBatchKMeans &operator=(MiniBatchKMeans &&) = delete;
+    ~MiniBatchKMeans() = default;
+
+    // k-means++ on a batch; each centroid starts as the mean of its seed's points
+    void seed(const std::vector<double> &batch, size_t count, Random &random);
+    // Assigns the batch and moves the centroids; adds every point's squared
+    // distance at assignment time to its cluster's entry in sums
+    void step(const std::vector<double> &batch, size_t count, std::vector<double> &sums);
+    // Nearest centroid of one point and the squared distance to it
+    size_t nearest(const double *point, double &distance) const;
+    Point centroid(size_t c) const;
+};
+
+// Clusters the file in sampled mini-batches, as many per pass as the file
+// holds batches, and prints per pass the sums at assignment time, then the
+// exact SSE, cardinality and entropy per cluster from one sequential pass
+void runMiniBatch(const std::string &path, int k, size_t batchSize, size_t passes, Random &random);
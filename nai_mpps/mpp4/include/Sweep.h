@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include "KMeans.h"
+#include "Random.h"
+#include "ThreadPool.h"
+
+// Points the silhouette of every K is measured on
+#define SILHOUETTE_SAMPLE 2000
+
+// Quality of the clustering found for one K
+struct SweepResult
+{
+    int K = 0;
+    double SSE = 0;
+    // Entropy of the decision attribute within a cluster, weighted by cluster size
+    double Entropy = 0;
+    double Silhouette = 0;
+    // Of the kept run
+    int Iterations = 0;
+    // Of all restarts
+    double Seconds = 0;
+};
+
+// Mean silhouette of the sampled points, measured against the other sampled
+// points only: O(sample^2) distances instead of O(N^2). A point alone in its
+// cluster within the sample counts 0, as does every point for a single cluster.
+double sampledSilhouette(const std::vector<Point> &points, const std::vector<int> &labels, const std::vector<size_t> &sample);
+
+// Clusters the points for every K in [kMin, kMax], one pool job per K that
+// keeps the lowest SSE of `restarts` runs, each seeded from its own stream.
+// Prints SSE, entropy and silhouette per K together with the elbow and the K
+// of the best silhouette. The elbow is the knee of the SSE curve (Satopää et
+// al., "Kneedle"): with K and SSE scaled to [0, 1] over the range, the K whose
+// SSE lies farthest below the line from the first K's SSE to the last one's.
+void runSweep(const std::vector<Point> &points, int kMin, int kMax, size_t restarts, Variant variant, bool plusPlus, ThreadPool &pool, Random &random);
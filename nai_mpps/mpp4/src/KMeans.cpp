@@ -0,0 +1,689 @@
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include "KMeans.h"
+
+double entropy(const std::unordered_map<std::string, int> &occurances, size_t total)
+{
+    double entropy = 0;
+    for (auto it = occurances.begin(); it != occurances.end(); it++)
+    {
+        double probability = (double)(*it).second / total;
+        entropy += probability * log2(probability);
+    }
+
+    return -entropy + 0.0f;
+}
+
+std::vector<double> clusterEntropies(const std::vector<Point> &points, const std::vector<int> &labels, size_t k)
+{
+    std::vector<std::unordered_map<std::string, int>> occurances(k);
+    std::vector<size_t> cardinalities(k, 0);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        occurances[labels[i]][points[i].DecisionAttribute]++;
+        cardinalities[labels[i]]++;
+    }
+
+    std::vector<double> entropies(k);
+    for (size_t c = 0; c < k; c++)
+    {
+        entropies[c] = entropy(occurances[c], cardinalities[c]);
+    }
+
+    return entropies;
+}
+
+void Centroids::set(size_t c, const Point &point)
+{
+    for (size_t d = 0; d < Dimensions; d++)
+    {
+        Coordinates[d * K + c] = point.Coordinates[d];
+    }
+};
+
+double Centroids::distanceSquare(const Point &point, size_t c) const
+{
+    double result = 0;
+    for (size_t d = 0; d < Dimensions; d++)
+    {
+        double difference = point.Coordinates[d] - Coordinates[d * K + c];
+        result += difference * difference;
+    }
+
+    return result;
+};
+
+void Centroids::distancesSquare(const Point &point, double *distances) const
+{
+    std::fill_n(distances, K, 0.0);
+    for (size_t d = 0; d < Dimensions; d++)
+    {
+        const double coordinate = point.Coordinates[d];
+        const double *row = Coordinates.data() + d * K;
+        for (size_t c = 0; c < K; c++)
+        {
+            double difference = coordinate - row[c];
+            distances[c] += difference * difference;
+        }
+    }
+};
+
+void ClusterTotals::means(Centroids &centroids) const
+{
+    for (size_t c = 0; c < centroids.K; c++)
+    {
+        for (size_t d = 0; d < centroids.Dimensions; d++)
+        {
+            centroids.Coordinates[d * centroids.K + c] = Counts[c] == 0 ? DBL_MAX : Sums[c * centroids.Dimensions + d] / Counts[c];
+        }
+    }
+};
+
+double distanceSquare(const Point &a, const Point &b)
+{
+    if (a.Coordinates.size() != b.Coordinates.size())
+    {
+        throw std::invalid_argument("Invalid points dimensions");
+    }
+
+    double result = 0;
+    size_t size = a.Coordinates.size();
+    for (size_t i = 0; i < size; i++)
+    {
+        result += (a.Coordinates[i] - b.Coordinates[i]) * (a.Coordinates[i] - b.Coordinates[i]);
+    }
+
+    return result;
+};
+
+int initializeClustersRandomly(int k, const std::vector<Point> &points, std::vector<int> &labels, Random &random)
+{
+    std::vector<size_t> remaining(points.size());
+    std::iota(remaining.begin(), remaining.end(), 0);
+    labels.assign(points.size(), 0);
+    int minNumberPointsInCluster = points.size() / k;
+
+    for (int i = 0; i < k; i++)
+    {
+        for (int counter = 0; counter < minNumberPointsInCluster; counter++)
+        {
+            int selectedElement = random.below(remaining.size());
+            //swap
+            labels[remaining[selectedElement]] = i;
+            remaining[selectedElement] = remaining.back();
+            remaining.pop_back();
+        }
+    }
+
+    while (remaining.size() != 0)
+    {
+        int selectedCluster = random.below(k);
+        int selectedElement = random.below(remaining.size());
+        //swap
+        labels[remaining[selectedElement]] = selectedCluster;
+        remaining[selectedElement] = remaining.back();
+        remaining.pop_back();
+    }
+
+    return 0;
+};
+
+// k-means++ (Arthur & Vassilvitskii): the first centroid is a uniformly drawn
+// point, every further one a point drawn with probability proportional to its
+// squared distance to the nearest centroid chosen so far. The seeds are spread
+// over the data, so Lloyd's loop starts close to a good local optimum. Every
+// point then joins the cluster of its nearest seed.
+int initializeClustersPlusPlus(int k, const std::vector<Point> &points, std::vector<int> &labels, Random &random, std::vector<size_t> *seeds)
+{
+    std::vector<double> nearest(points.size(), DBL_MAX);
+    labels.assign(points.size(), 0);
+    if (seeds != nullptr)
+    {
+        seeds->assign(k, 0);
+    }
+
+    size_t chosen = random.below(points.size());
+    for (int c = 0; c < k; c++)
+    {
+        if (seeds != nullptr)
+        {
+            (*seeds)[c] = chosen;
+        }
+
+        const Point seed = points[chosen];
+        double total = 0;
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            double d = distanceSquare(points[i], seed);
+            if (d < nearest[i])
+            {
+                nearest[i] = d;
+                labels[i] = c;
+            }
+
+            total += nearest[i];
+        }
+
+        // Every point already is a centroid: the remaining seeds are duplicates
+        if (total == 0)
+        {
+            chosen = random.below(points.size());
+            continue;
+        }
+
+        double target = random.uniform() * total;
+        chosen = points.size() - 1;
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            target -= nearest[i];
+            if (target < 0 && nearest[i] > 0)
+            {
+                chosen = i;
+                break;
+            }
+        }
+    }
+
+    return 0;
+};
+
+Variant parseVariant(const std::string &name)
+{
+    for (Variant variant : {Variant::Lloyd, Variant::Hamerly, Variant::Elkan})
+    {
+        if (name == variantName(variant))
+        {
+            return variant;
+        }
+    }
+
+    throw std::invalid_argument("Unknown k-means variant " + name + " (lloyd, hamerly or elkan)");
+};
+
+const char *variantName(Variant variant)
+{
+    switch (variant)
+    {
+    case Variant::Hamerly:
+        return "hamerly";
+    case Variant::Elkan:
+        return "elkan";
+    default:
+        return "lloyd";
+    }
+};
+
+Assignment::Assignment(const std::vector<Point> &points, size_t k, Variant variant, const std::vector<int> &labels, ThreadPool *pool)
+    : m_points(points), m_k(k), m_variant(variant), m_pool(pool), m_labels(labels),
+      m_centroids(k, points.empty() ? 0 : points[0].Coordinates.size())
+{
+    if (labels.size() != points.size())
+    {
+        throw std::logic_error("Every point needs an initial label");
+    }
+
+    m_upper.assign(points.size(), INFINITY);
+    m_lower.assign(variant == Variant::Elkan ? points.size() * k : points.size(), 0.0);
+    m_stale.assign(points.size(), 1);
+
+    size_t chunks = pool == nullptr ? 1 : pool->size() * CHUNKS_PER_THREAD;
+    chunks = std::max<size_t>(1, std::min(chunks, points.size() / MIN_CHUNK_POINTS));
+    const size_t dimensions = m_centroids.Dimensions;
+    m_partials.resize(chunks);
+    for (size_t c = 0; c < chunks; c++)
+    {
+        m_partials[c].Begin = points.size() * c / chunks;
+        m_partials[c].End = points.size() * (c + 1) / chunks;
+        m_partials[c].Totals.Sums.resize(k * dimensions);
+        m_partials[c].Totals.Counts.resize(k);
+        m_partials[c].Totals.Distances.resize(k);
+        m_partials[c].Distances.resize(k);
+    }
+};
+
+double Assignment::distance(size_t point, size_t centroid) const
+{
+    return std::sqrt(m_centroids.distanceSquare(m_points[point], centroid));
+};
+
+void Assignment::forEachChunk(const std::function<void(Partial &)> &job)
+{
+    if (m_pool == nullptr || m_partials.size() == 1)
+    {
+        for (Partial &partial : m_partials)
+        {
+            job(partial);
+        }
+
+        return;
+    }
+
+    for (Partial &partial : m_partials)
+    {
+        m_pool->submit([&job, &partial]() { job(partial); });
+    }
+
+    m_pool->wait();
+};
+
+void Assignment::moveCentroids(const Centroids &centroids, AssignmentStats &stats)
+{
+    if (centroids.K != m_k || centroids.Dimensions != m_centroids.Dimensions)
+    {
+        throw std::logic_error("Expected one centroid per cluster");
+    }
+
+    if (m_variant == Variant::Lloyd || !m_bounded)
+    {
+        m_centroids = centroids;
+        return;
+    }
+
+    std::vector<double> drifts(m_k, 0.0);
+    for (size_t i = 0; i < centroids.Coordinates.size(); i++)
+    {
+        double difference = centroids.Coordinates[i] - m_centroids.Coordinates[i];
+        drifts[i % m_k] += difference * difference;
+    }
+
+    size_t farthest = 0;
+    for (size_t j = 0; j < m_k; j++)
+    {
+        drifts[j] = std::sqrt(drifts[j]);
+        farthest = drifts[j] > drifts[farthest] ? j : farthest;
+    }
+
+    stats.Evaluations += m_k;
+    m_centroids = centroids;
+
+    // Hamerly's single lower bound covers every other centroid, so it drops by
+    // the largest drift of any centroid but the point's own
+    double runnerUp = 0;
+    for (size_t j = 0; j < m_k; j++)
+    {
+        runnerUp = j != farthest ? std::max(runnerUp, drifts[j]) : runnerUp;
+    }
+
+    forEachChunk([&](Partial &partial) {
+        for (size_t i = partial.Begin; i < partial.End; i++)
+        {
+            m_upper[i] += drifts[m_labels[i]];
+            if (m_variant == Variant::Hamerly)
+            {
+                m_lower[i] = std::max(0.0, m_lower[i] - ((size_t)m_labels[i] == farthest ? runnerUp : drifts[farthest]));
+                continue;
+            }
+
+            double *lower = m_lower.data() + i * m_k;
+            for (size_t j = 0; j < m_k; j++)
+            {
+                lower[j] = std::max(0.0, lower[j] - drifts[j]);
+            }
+
+            m_stale[i] = 1;
+        }
+    });
+};
+
+void Assignment::computeCentroidDistances(AssignmentStats &stats)
+{
+    m_centroidDistances.assign(m_k * m_k, 0.0);
+    m_halfNearest.assign(m_k, INFINITY);
+    for (size_t a = 0; a < m_k; a++)
+    {
+        for (size_t b = a + 1; b < m_k; b++)
+        {
+            double d = 0;
+            for (size_t dimension = 0; dimension < m_centroids.Dimensions; dimension++)
+            {
+                double difference = m_centroids.at(a, dimension) - m_centroids.at(b, dimension);
+                d += difference * difference;
+            }
+
+            d = std::sqrt(d);
+            m_centroidDistances[a * m_k + b] = d;
+            m_centroidDistances[b * m_k + a] = d;
+            m_halfNearest[a] = std::min(m_halfNearest[a], d / 2);
+            m_halfNearest[b] = std::min(m_halfNearest[b], d / 2);
+        }
+    }
+
+    stats.Evaluations += m_k * (m_k - 1) / 2;
+};
+
+void Assignment::assignExactly(size_t point, Partial &partial)
+{
+    double *distances = partial.Distances.data();
+    m_centroids.distancesSquare(m_points[point], distances);
+    double nearest = INFINITY;
+    double second = INFINITY;
+    int label = 0;
+    for (size_t j = 0; j < m_k; j++)
+    {
+        double d = std::sqrt(distances[j]);
+        if (m_variant == Variant::Elkan)
+        {
+            m_lower[point * m_k + j] = d;
+        }
+
+        if (d < nearest)
+        {
+            second = nearest;
+            nearest = d;
+            label = j;
+        }
+        else if (d < second)
+        {
+            second = d;
+        }
+    }
+
+    partial.Stats.Evaluations += m_k;
+    partial.Stats.Changes += m_labels[point] != label;
+    m_labels[point] = label;
+    m_upper[point] = nearest;
+    m_stale[point] = 0;
+    if (m_variant == Variant::Hamerly)
+    {
+        m_lower[point] = second;
+    }
+};
+
+void Assignment::updateLloyd(Partial &partial)
+{
+    double *distances = partial.Distances.data();
+    for (size_t i = partial.Begin; i < partial.End; i++)
+    {
+        m_centroids.distancesSquare(m_points[i], distances);
+        double minDistance = DBL_MAX;
+        int minClusterIndex = 0;
+        for (size_t j = 0; j < m_k; j++)
+        {
+            if (distances[j] < minDistance)
+            {
+                minDistance = distances[j];
+                minClusterIndex = j;
+            }
+        }
+
+        partial.Stats.Changes += m_labels[i] != minClusterIndex;
+        m_labels[i] = minClusterIndex;
+    }
+
+    partial.Stats.Evaluations += (partial.End - partial.Begin) * m_k;
+};
+
+void Assignment::updateHamerly(Partial &partial)
+{
+    AssignmentStats &stats = partial.Stats;
+    for (size_t i = partial.Begin; i < partial.End; i++)
+    {
+        double bound = std::max(m_halfNearest[m_labels[i]], m_lower[i]);
+        if (m_upper[i] <= bound)
+        {
+            continue;
+        }
+
+        // Tighten the upper bound before paying for all K distances
+        m_upper[i] = distance(i, m_labels[i]);
+        stats.Evaluations++;
+        if (m_upper[i] <= bound)
+        {
+            continue;
+        }
+
+        assignExactly(i, partial);
+    }
+};
+
+void Assignment::updateElkan(Partial &partial)
+{
+    AssignmentStats &stats = partial.Stats;
+    for (size_t i = partial.Begin; i < partial.End; i++)
+    {
+        size_t label = m_labels[i];
+        if (m_upper[i] <= m_halfNearest[label])
+        {
+            continue;
+        }
+
+        double *lower = m_lower.data() + i * m_k;
+        for (size_t j = 0; j < m_k; j++)
+        {
+            // j cannot be nearer than the current centroid
+            if (j == label || m_upper[i] <= lower[j] || m_upper[i] <= m_centroidDistances[label * m_k + j] / 2)
+            {
+                continue;
+            }
+
+            if (m_stale[i])
+            {
+                m_upper[i] = distance(i, label);
+                lower[label] = m_upper[i];
+                m_stale[i] = 0;
+                stats.Evaluations++;
+                if (m_upper[i] <= lower[j] || m_upper[i] <= m_centroidDistances[label * m_k + j] / 2)
+                {
+                    continue;
+                }
+            }
+
+            lower[j] = distance(i, j);
+            stats.Evaluations++;
+            if (lower[j] < m_upper[i])
+            {
+                label = j;
+                m_upper[i] = lower[j];
+            }
+        }
+
+        stats.Changes += (size_t)m_labels[i] != label;
+        m_labels[i] = label;
+    }
+};
+
+AssignmentStats Assignment::update(const Centroids &centroids)
+{
+    AssignmentStats stats{};
+    moveCentroids(centroids, stats);
+    const bool bounded = m_bounded;
+    if (m_variant != Variant::Lloyd && bounded)
+    {
+        computeCentroidDistances(stats);
+    }
+
+    forEachChunk([&](Partial &partial) {
+        partial.Stats = {};
+        if (m_variant == Variant::Lloyd)
+        {
+            updateLloyd(partial);
+        }
+        else if (!bounded)
+        {
+            // No bounds yet: one full scan sets them
+            for (size_t i = partial.Begin; i < partial.End; i++)
+            {
+                assignExactly(i, partial);
+            }
+        }
+        else if (m_variant == Variant::Hamerly)
+        {
+            updateHamerly(partial);
+        }
+        else
+        {
+            updateElkan(partial);
+        }
+    });
+
+    m_bounded = m_variant != Variant::Lloyd;
+    for (const Partial &partial : m_partials)
+    {
+        stats.Evaluations += partial.Stats.Evaluations;
+        stats.Changes += partial.Stats.Changes;
+    }
+
+    stats.Avoided = (int64_t)(m_points.size() * m_k) - (int64_t)stats.Evaluations;
+    return stats;
+};
+
+int Assignment::reseedEmptyClusters(Centroids &centroids)
+{
+    std::vector<size_t> sizes(m_k, 0);
+    for (int label : m_labels)
+    {
+        sizes[label]++;
+    }
+
+    // A cluster that no point is nearest to would keep an undefined centroid
+    // and never win a point again. It takes over the point farthest from its
+    // own centroid instead, which also splits the worst fitted cluster.
+    int reseeded = 0;
+    for (size_t empty = 0; empty < m_k; empty++)
+    {
+        if (sizes[empty] != 0)
+        {
+            continue;
+        }
+
+        size_t farthest = SIZE_MAX;
+        double maxDistance = -1;
+        for (size_t i = 0; i < m_points.size(); i++)
+        {
+            // A single point would leave its cluster empty in turn
+            if (sizes[m_labels[i]] < 2)
+            {
+                continue;
+            }
+
+            double d = m_centroids.distanceSquare(m_points[i], m_labels[i]);
+            if (d > maxDistance)
+            {
+                maxDistance = d;
+                farthest = i;
+            }
+        }
+
+        if (farthest == SIZE_MAX)
+        {
+            break;
+        }
+
+        sizes[m_labels[farthest]]--;
+        sizes[empty]++;
+        m_labels[farthest] = empty;
+        centroids.set(empty, m_points[farthest]);
+        // Nothing is known about the point's distances to the next centroids
+        m_upper[farthest] = INFINITY;
+        m_stale[farthest] = 1;
+        std::fill_n(m_lower.begin() + (m_variant == Variant::Elkan ? farthest * m_k : farthest),
+                    m_variant == Variant::Elkan ? m_k : 1, 0.0);
+        reseeded++;
+    }
+
+    return reseeded;
+};
+
+void Assignment::reduce(const Centroids *centroids, ClusterTotals &totals)
+{
+    const size_t dimensions = m_centroids.Dimensions;
+    forEachChunk([&](Partial &partial) {
+        ClusterTotals &local = partial.Totals;
+        std::fill(local.Sums.begin(), local.Sums.end(), 0.0);
+        std::fill(local.Counts.begin(), local.Counts.end(), 0);
+        std::fill(local.Distances.begin(), local.Distances.end(), 0.0);
+        for (size_t i = partial.Begin; i < partial.End; i++)
+        {
+            const size_t label = m_labels[i];
+            const double *coordinates = m_points[i].Coordinates.data();
+            double *sums = local.Sums.data() + label * dimensions;
+            for (size_t d = 0; d < dimensions; d++)
+            {
+                sums[d] += coordinates[d];
+            }
+
+            local.Counts[label]++;
+            if (centroids != nullptr)
+            {
+                local.Distances[label] += centroids->distanceSquare(m_points[i], label);
+            }
+        }
+    });
+
+    totals.Sums.assign(m_k * dimensions, 0.0);
+    totals.Counts.assign(m_k, 0);
+    totals.Distances.assign(m_k, 0.0);
+    for (const Partial &partial : m_partials)
+    {
+        for (size_t j = 0; j < totals.Sums.size(); j++)
+        {
+            totals.Sums[j] += partial.Totals.Sums[j];
+        }
+
+        for (size_t c = 0; c < m_k; c++)
+        {
+            totals.Counts[c] += partial.Totals.Counts[c];
+            totals.Distances[c] += partial.Totals.Distances[c];
+        }
+    }
+};
+
+KMeansResult runKMeans(const std::vector<Point> &points, int k, Variant variant, const std::vector<int> &labels, ThreadPool *pool, std::ostream *log)
+{
+    const auto start = std::chrono::steady_clock::now();
+    KMeansResult result{};
+    Assignment assignment(points, k, variant, labels, pool);
+    assignment.reduce(nullptr, result.Totals);
+
+    // Converged once an iteration moves no point to another cluster: the
+    // centroids of the next one would be the same
+    Centroids centroids(k, points[0].Coordinates.size());
+    size_t changes = points.size();
+    while (changes != 0)
+    {
+        result.Totals.means(centroids);
+
+        AssignmentStats stats = assignment.update(centroids);
+        int reseeded = assignment.reseedEmptyClusters(centroids);
+        assignment.reduce(&centroids, result.Totals);
+        changes = stats.Changes + reseeded;
+        result.Evaluations += stats.Evaluations;
+        result.Avoided += stats.Avoided;
+
+        result.SSE = 0;
+        for (int i = 0; i < k; i++)
+        {
+            result.SSE += result.Totals.Distances[i];
+        }
+
+        if (log == nullptr)
+        {
+            result.Iterations++;
+            continue;
+        }
+
+        *log << "ITERATION " << result.Iterations++ << std::endl;
+        *log << "Label changes: " << changes << std::endl;
+        *log << "Distance evaluations: " << stats.Evaluations << " (avoided " << stats.Avoided << ")" << std::endl;
+        if (reseeded != 0)
+        {
+            *log << "Reseeded empty clusters: " << reseeded << std::endl;
+        }
+
+        for (int i = 0; i < k; i++)
+        {
+            *log << "Cluster " << i << " sum: " << result.Totals.Distances[i] << std::endl;
+        }
+
+        *log << "Total sum: " << result.SSE << std::endl;
+    }
+
+    result.Labels = assignment.labels();
+    result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+};
@@ -7,138 +7,24 @@
 #include <regex>
 #include <cstdarg>
 #include <algorithm>
+#include <chrono>
 #include <map>
 #include <stdexcept>
 #include <unordered_map>
 
+#include "KMeans.h"
+#include "MiniBatch.h"
+#include "Random.h"
+#include "Sweep.h"
+#include "ThreadPool.h"
+
 #define WORD_SEPARATOR "\\s"
 #define LOCAL "pl-PL"
 #define DATA_PATH "./res/iris_training.txt"
 
-struct Point
-{
-    std::vector<double> Coordinates{};
-    std::string DecisionAttribute{};
-
-    friend bool operator!=(const Point &l, const Point &r);
-};
-
-struct Cluster
-{
-    std::vector<Point> Points{};
-    Point Centroid{};
-
-    void computeCentroid();
-    double computeDistancesSum();
-    int cardinality();
-    double entropy();
-    friend bool operator!=(const Cluster &l, const Cluster &r);
-};
-
-double distanceSquare(Point &a, Point &b);
 std::vector<std::string> tokenize(const std::string str, const std::regex re);
 const std::string format(const char *fmt, ...);
 const std::ifstream &operator>>(std::ifstream &ofs, std::vector<Point> &points);
-int initializeClustersRandomly(int k, std::vector<Point> points, std::vector<Cluster> &result);
-
-void Cluster::computeCentroid()
-{
-    if (Points.empty())
-    {
-        for (size_t i = 0; i < Centroid.Coordinates.size(); i++)
-        {
-            Centroid.Coordinates[i] = DBL_MAX;
-        }
-
-        return;
-    }
-
-    if (Centroid.Coordinates.size() != Points[0].Coordinates.size())
-    {
-        Centroid.Coordinates = std::vector<double>(Points[0].Coordinates.size(), 0.0f);
-    }
-
-    for (size_t i = 0; i < Points[0].Coordinates.size(); i++)
-    {
-        double sumCoordinate = 0;
-        for (size_t j = 0; j < Points.size(); j++)
-        {
-            sumCoordinate += Points[j].Coordinates[i];
-        }
-
-        Centroid.Coordinates[i] = sumCoordinate / Points.size();
-    }
-};
-
-int Cluster::cardinality()
-{
-    return Points.size();
-}
-
-double Cluster::entropy()
-{
-    std::unordered_map<std::string, int> occurances{};
-    for (size_t i = 0; i < Points.size(); i++)
-    {
-        auto it = occurances.find(Points[i].DecisionAttribute);
-        if (occurances.find(Points[i].DecisionAttribute) == occurances.end())
-        {
-            occurances.insert({Points[i].DecisionAttribute, 1});
-            continue;
-        }
-
-        (*it).second++;
-    }
-
-    double entropy = 0;
-    for (auto it = occurances.begin(); it != occurances.end(); it++)
-    {
-        double probability = (double)(*it).second / Points.size();
-        entropy += probability * log2(probability);
-    }
-
-    return -entropy + 0.0f;
-}
-
-bool operator!=(const Point &l, const Point &r)
-{
-    if (l.Coordinates.size() != r.Coordinates.size())
-    {
-        return true;
-    }
-
-    for (size_t i = 0; i < l.Coordinates.size(); i++)
-    {
-        if (l.Coordinates[i] != r.Coordinates[i])
-        {
-            return true;
-        }
-    }
-
-    return false;
-};
-
-bool operator!=(const Cluster &l, const Cluster &r)
-{
-    return l.Centroid != r.Centroid || l.Points.size() != r.Points.size();
-};
-
-double distanceSquare(Point &a, Point &b)
-{
-    if (a.Coordinates.size() != b.Coordinates.size())
-    {
-        throw std::exception("Invalid points dimensions");
-    }
-
-    double result = 0;
-    size_t size = a.Coordinates.size();
-    for (size_t i = 0; i < size; i++)
-    {
-        result += (a.Coordinates[i] - b.Coordinates[i]) * (a.Coordinates[i] - b.Coordinates[i]);
-    }
-
-    return result;
-};
 
 const std::string format(const char *fmt, ...)
 {
@@ -199,76 +85,112 @@ const std::ifstream &operator>>(std::ifstream &ofs, std::vector<Point> &points)
     return ofs;
 };
 
-int initializeClustersRandomly(int k, std::vector<Point> points, std::vector<Cluster> &clusters)
+int main(int argc, char const *argv[])
 {
-    int pointsCount = points.size();
-    int minNumberPointsInCluster = pointsCount / k;
+    setlocale(LC_ALL, LOCAL);
 
-    for (size_t i = 0; i < k; i++)
+    // "--seed N" reproduces a previous run, "--init random" starts from
+    // random partitions instead of k-means++ seeds, "--variant lloyd|hamerly|elkan"
+    // picks the assignment step and "--data path" another data file.
+    // "--minibatch N" streams the file in batches of N points instead of
+    // loading it, for "--passes P" passes. "--threads N" sets the threads of
+    // every iteration, one per hardware thread by default. "--restarts R"
+    // runs R differently seeded k-means at once and keeps the lowest SSE.
+    // "--sweep A:B" clusters for every K from A to B instead of asking for
+    // one, keeping the best of the restarts for each
+    uint64_t seed = (uint64_t)time(NULL);
+    bool plusPlus = true;
+    Variant variant = Variant::Hamerly;
+    std::string dataPath = DATA_PATH;
+    size_t batchSize = 0;
+    size_t passes = MINIBATCH_PASSES;
+    size_t threads = 0;
+    size_t restarts = 1;
+    int sweepMin = 0;
+    int sweepMax = 0;
+    for (int i = 1; i + 1 < argc; i++)
     {
-        int counter = 0;
-        while (counter < minNumberPointsInCluster)
+        if (std::string(argv[i]) == "--seed")
+        {
+            seed = std::stoull(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--init")
+        {
+            plusPlus = std::string(argv[i + 1]) != "random";
+        }
+        else if (std::string(argv[i]) == "--variant")
+        {
+            variant = parseVariant(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--data")
+        {
+            dataPath = argv[i + 1];
+        }
+        else if (std::string(argv[i]) == "--minibatch")
+        {
+            batchSize = std::stoull(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--passes")
         {
-            int selectedElement = rand() % points.size();
-            //swap
-            Point point = points[selectedElement];
-            points[selectedElement] = points.back();
-            points.pop_back();
+            passes = std::stoull(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--threads")
+        {
+            threads = std::stoull(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--restarts")
+        {
+            restarts = std::stoull(argv[i + 1]);
+        }
+        else if (std::string(argv[i]) == "--sweep")
+        {
+            std::string range = argv[i + 1];
+            size_t colon = range.find(':');
+            if (colon == std::string::npos)
+            {
+                throw std::invalid_argument("Expected a K range like 2:10 after --sweep");
+            }
 
-            clusters[i].Points.push_back(point);
-            counter++;
+            sweepMin = std::stoi(range.substr(0, colon));
+            sweepMax = std::stoi(range.substr(colon + 1));
         }
     }
 
-    while (points.size() != 0)
+    std::cout << "Seed: " << seed << std::endl;
+    Random random(seed);
+
+    int k = 0;
+    if (batchSize != 0)
     {
-        int selectedCluster = rand() % clusters.size();
-        int selectedElement = rand() % points.size();
-        //swap
-        Point point = points[selectedElement];
-        points[selectedElement] = points.back();
-        points.pop_back();
+        std::cout << "Enter K: ";
+        std::cin >> k;
+        if (k <= 0 || (size_t)k > batchSize)
+        {
+            std::cout << "Invalid K value" << std::endl;
+            return 0;
+        }
 
-        clusters[selectedCluster].Points.push_back(point);
+        runMiniBatch(dataPath, k, batchSize, passes, random);
+        return 0;
     }
 
-    return 0;
-};
+    std::vector<Point> points{};
+    std::ifstream data_file(dataPath);
+    data_file >> points;
 
-bool isEqual(const std::vector<Cluster> &l, const std::vector<Cluster> &r)
-{
-    for (size_t i = 0; i < l.size(); i++)
+    if (sweepMax != 0)
     {
-        if (l[i] != r[i])
+        if (sweepMin <= 0 || sweepMin > sweepMax || sweepMax >= (int)points.size())
         {
-            return false;
+            std::cout << "Invalid K range" << std::endl;
+            return 0;
         }
-    }
 
-    return true;
-}
-
-double Cluster::computeDistancesSum()
-{
-    double sum = 0;
-    for (size_t i = 0; i < Points.size(); i++)
-    {
-        sum += distanceSquare(Points[i], Centroid);
+        ThreadPool pool(threads);
+        runSweep(points, sweepMin, sweepMax, std::max<size_t>(restarts, 1), variant, plusPlus, pool, random);
+        return 0;
     }
 
-    return sum;
-}
-
-int main()
-{
-    setlocale(LC_ALL, LOCAL);
-    srand(time(NULL));
-
-    std::vector<Point> points{};
-    std::ifstream data_file(DATA_PATH);
-    data_file >> points;
-
-    int k = 0;
     std::cout << "Enter K: ";
     std::cin >> k;
 
@@ -284,57 +206,73 @@ int main()
         return 0;
     }
 
-    std::vector<Cluster> clusters(k, Cluster{});
-
-    initializeClustersRandomly(k, points, clusters);
-
-    int counter = 0;
-    std::vector<Cluster> oldClusters(k, Cluster{});
-    while (!isEqual(clusters, oldClusters))
-    {
-        oldClusters = clusters;
-        for (size_t i = 0; i < clusters.size(); i++)
+    // Initial partitions of a run drawn from generator
+    auto initialize = [&](std::vector<int> &labels, Random &generator) {
+        if (plusPlus)
         {
-            clusters[i].computeCentroid();
-            clusters[i].Points.clear();
+            initializeClustersPlusPlus(k, points, labels, generator);
         }
-
-        for (size_t i = 0; i < points.size(); i++)
+        else
         {
-            double minDistance = DBL_MAX;
-            int minClusterIndex = 0;
-            for (size_t j = 0; j < clusters.size(); j++)
-            {
-                double d = distanceSquare(points[i], clusters[j].Centroid);
-                if (d < minDistance)
-                {
-                    minDistance = d;
-                    minClusterIndex = j;
-                }
-            }
+            initializeClustersRandomly(k, points, labels, generator);
+        }
+    };
 
-            clusters[minClusterIndex].Points.push_back(points[i]);
+    ThreadPool pool(threads);
+    KMeansResult result{};
+    if (restarts <= 1)
+    {
+        std::vector<int> labels{};
+        initialize(labels, random);
+        result = runKMeans(points, k, variant, labels, &pool, &std::cout);
+    }
+    else
+    {
+        // One restart per job on its own generator stream, so the restarts
+        // only share the read-only points and a run is reproduced from its
+        // seed however the jobs are scheduled. Each restart is serial; the
+        // pool runs them side by side.
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<KMeansResult> results(restarts);
+        for (size_t r = 0; r < restarts; r++)
+        {
+            pool.submit([&, r]() {
+                Random generator = random.stream(r);
+                std::vector<int> labels{};
+                initialize(labels, generator);
+                results[r] = runKMeans(points, k, variant, labels, nullptr, nullptr);
+            });
         }
 
-        double totalSum = 0;
-        std::cout << "ITERATION " << counter++ << std::endl;
-        for (size_t i = 0; i < clusters.size(); i++)
+        pool.wait();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        size_t best = 0;
+        for (size_t r = 0; r < restarts; r++)
         {
-            double itSum = clusters[i].computeDistancesSum();
-            std::cout << "Cluster " << i << " sum: " << itSum << std::endl;
-            totalSum += itSum;
+            std::cout << "RESTART " << r << ": SSE = " << results[r].SSE << ", iterations = " << results[r].Iterations
+                      << ", distance evaluations = " << results[r].Evaluations << ", seconds = " << results[r].Seconds << std::endl;
+            best = results[r].SSE < results[best].SSE ? r : best;
         }
 
-        std::cout << "Total sum: " << totalSum << std::endl;
+        std::cout << "Restarts took " << seconds << " s" << std::endl;
+        std::cout << "Best restart = " << best << std::endl;
+        result = std::move(results[best]);
     }
 
     std::cout << std::endl;
     std::cout << "FINALL RESULTS" << std::endl;
-    for (size_t i = 0; i < clusters.size(); i++)
+    std::cout << "Iterations = " << result.Iterations << std::endl;
+    std::cout << "SSE = " << result.SSE << std::endl;
+    std::cout << "Variant = " << variantName(variant) << std::endl;
+    std::cout << "Distance evaluations = " << result.Evaluations << " (avoided " << result.Avoided << ")" << std::endl;
+    std::cout << "Threads = " << pool.size() << std::endl;
+    std::vector<double> entropies = clusterEntropies(points, result.Labels, k);
+    for (int i = 0; i < k; i++)
     {
         std::cout << "Cluster " << i << ": " << std::endl;
-        std::cout << "Cardinality = " << clusters[i].cardinality() << std::endl;
-        std::cout << "Entropy = " << clusters[i].entropy() << std::endl;
+        std::cout << "Cardinality = " << result.Totals.Counts[i] << std::endl;
+        std::cout << "Entropy = " << entropies[i] << std::endl;
     }
 
     return 0;
@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include "MiniBatch.h"
+
+static double distanceSquare(const double *a, const double *b, size_t dimensions)
+{
+    double result = 0;
+    for (size_t i = 0; i < dimensions; i++)
+    {
+        result += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+
+    return result;
+}
+
+// Splits a line at whitespace; the words are views into the line
+static void splitWords(const std::string &line, std::vector<std::pair<size_t, size_t>> &words)
+{
+    words.clear();
+    size_t i = 0;
+    while (i < line.size())
+    {
+        while (i < line.size() && std::isspace((unsigned char)line[i]))
+        {
+            i++;
+        }
+
+        size_t begin = i;
+        while (i < line.size() && !std::isspace((unsigned char)line[i]))
+        {
+            i++;
+        }
+
+        if (i > begin)
+        {
+            words.push_back({begin, i - begin});
+        }
+    }
+}
+
+PointReader::PointReader(const std::string &path) : m_path(path), m_file(path)
+{
+    if (m_file.good() == false)
+    {
+        throw std::ifstream::failure("Exception opening/reading/closing file");
+    }
+
+    m_file.seekg(0, std::ios::end);
+    m_size = (uint64_t)m_file.tellg();
+    m_file.seekg(0);
+    while (m_words.empty() && std::getline(m_file, m_line))
+    {
+        splitWords(m_line, m_words);
+    }
+
+    if (m_words.size() < 2)
+    {
+        throw std::logic_error("No points in " + path);
+    }
+
+    m_dimensions = m_words.size() - 1;
+    rewind();
+};
+
+bool PointReader::parse(size_t slot, std::vector<double> &coordinates, std::vector<std::string> &attributes)
+{
+    splitWords(m_line, m_words);
+    if (m_words.empty())
+    {
+        return false;
+    }
+
+    if (m_words.size() - 1 != m_dimensions)
+    {
+        throw std::logic_error("Inconsistency in data set columns number in " + m_path + ": \"" + m_line + "\"");
+    }
+
+    // Same precision as the in-memory reader's std::stof
+    double *row = coordinates.data() + slot * m_dimensions;
+    for (size_t i = 0; i < m_dimensions; i++)
+    {
+        row[i] = std::strtof(m_line.c_str() + m_words[i].first, nullptr);
+    }
+
+    attributes[slot].assign(m_line, m_words.back().first, m_words.back().second);
+    return true;
+};
+
+size_t PointReader::read(size_t count, std::vector<double> &coordinates, std::vector<std::string> &attributes)
+{
+    coordinates.resize(count * m_dimensions);
+    attributes.resize(count);
+    size_t read = 0;
+    while (read < count && std::getline(m_file, m_line))
+    {
+        read += parse(read, coordinates, attributes);
+    }
+
+    coordinates.resize(read * m_dimensions);
+    attributes.resize(read);
+    return read;
+};
+
+void PointReader::sample(size_t count, size_t runs, std::vector<double> &coordinates, std::vector<std::string> &attributes, Random &random)
+{
+    coordinates.resize(count * m_dimensions);
+    attributes.resize(count);
+    size_t read = 0;
+    for (size_t run = 0; run < runs; run++)
+    {
+        const uint64_t offset = (uint64_t)(random.uniform() * m_size);
+        m_file.clear();
+        m_file.seekg(offset);
+        // The line the offset fell into is incomplete
+        if (offset != 0)
+        {
+            std::getline(m_file, m_line);
+        }
+
+        for (const size_t end = count * (run + 1) / runs; read < end;)
+        {
+            if (!std::getline(m_file, m_line))
+            {
+                m_file.clear();
+                m_file.seekg(0);
+                continue;
+            }
+
+            read += parse(read, coordinates, attributes);
+        }
+    }
+};
+
+uint64_t PointReader::position()
+{
+    return m_file.good() ? (uint64_t)m_file.tellg() : m_size;
+};
+
+void PointReader::rewind()
+{
+    m_file.clear();
+    m_file.seekg(0);
+};
+
+MiniBatchKMeans::MiniBatchKMeans(size_t k, size_t dimensions)
+    : m_k(k), m_dimensions(dimensions), m_centroids(k * dimensions, 0.0), m_counts(k, 0)
+{
+};
+
+void MiniBatchKMeans::seed(const std::vector<double> &batch, size_t count, Random &random)
+{
+    if (count < m_k)
+    {
+        throw std::invalid_argument("The seeding sample holds fewer points than K");
+    }
+
+    std::vector<Point> points(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        points[i].Coordinates.assign(batch.begin() + i * m_dimensions, batch.begin() + (i + 1) * m_dimensions);
+    }
+
+    std::vector<int> labels{};
+    std::vector<size_t> seeds{};
+    initializeClustersPlusPlus(m_k, points, labels, random, &seeds);
+    std::fill(m_centroids.begin(), m_centroids.end(), 0.0);
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        double *centroid = m_centroids.data() + labels[i] * m_dimensions;
+        for (size_t d = 0; d < m_dimensions; d++)
+        {
+            centroid[d] += points[i].Coordinates[d];
+        }
+
+        m_counts[labels[i]]++;
+    }
+
+    // A seed that duplicates an earlier one loses all its points to it (ties
+    // go to the first cluster), so such a cluster keeps its seed point as is
+    for (size_t c = 0; c < m_k; c++)
+    {
+        for (size_t d = 0; d < m_dimensions; d++)
+        {
+            m_centroids[c * m_dimensions + d] = m_counts[c] == 0
+                                                    ? points[seeds[c]].Coordinates[d]
+                                                    : m_centroids[c * m_dimensions + d] / m_counts[c];
+        }
+    }
+};
+
+size_t MiniBatchKMeans::nearest(const double *point, double &distance) const
+{
+    distance = DBL_MAX;
+    size_t nearest = 0;
+    for (size_t c = 0; c < m_k; c++)
+    {
+        double d = distanceSquare(point, m_centroids.data() + c * m_dimensions, m_dimensions);
+        if (d < distance)
+        {
+            distance = d;
+            nearest = c;
+        }
+    }
+
+    return nearest;
+};
+
+void MiniBatchKMeans::step(const std::vector<double> &batch, size_t count, std::vector<double> &sums)
+{
+    // Assign the whole batch first, so its points do not see each other's updates
+    m_labels.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        double distance = 0;
+        m_labels[i] = nearest(batch.data() + i * m_dimensions, distance);
+        sums[m_labels[i]] += distance;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        double *centroid = m_centroids.data() + m_labels[i] * m_dimensions;
+        const double *point = batch.data() + i * m_dimensions;
+        double rate = 1.0 / ++m_counts[m_labels[i]];
+        for (size_t d = 0; d < m_dimensions; d++)
+        {
+            centroid[d] += rate * (point[d] - centroid[d]);
+        }
+    }
+};
+
+Point MiniBatchKMeans::centroid(size_t c) const
+{
+    Point result{};
+    result.Coordinates.assign(m_centroids.begin() + c * m_dimensions, m_centroids.begin() + (c + 1) * m_dimensions);
+    return result;
+};
+
+void runMiniBatch(const std::string &path, int k, size_t batchSize, size_t passes, Random &random)
+{
+    PointReader reader(path);
+    std::vector<double> batch{};
+    std::vector<std::string> attributes{};
+    size_t count = reader.read(batchSize, batch, attributes);
+
+    // The first batch tells roughly how many batches the file holds
+    const double batchBytes = (double)reader.position() * batchSize / count;
+    const size_t batchesPerPass = std::max<size_t>(1, (size_t)(reader.size() / batchBytes + 0.5));
+    const size_t runs = std::min<size_t>(MINIBATCH_RUNS, batchSize);
+
+    // Seeded from a sample of the whole file, the first lines of a file
+    // sorted by class would put every seed into one class
+    MiniBatchKMeans kmeans(k, reader.dimensions());
+    reader.sample(batchSize, runs, batch, attributes, random);
+    kmeans.seed(batch, batchSize, random);
+
+    size_t batches = 0;
+    for (size_t pass = 0; pass < passes; pass++)
+    {
+        std::vector<double> sums(k, 0.0);
+        for (size_t b = 0; b < batchesPerPass; b++)
+        {
+            reader.sample(batchSize, runs, batch, attributes, random);
+            kmeans.step(batch, batchSize, sums);
+            batches++;
+        }
+
+        double totalSum = 0;
+        std::cout << "PASS " << pass << std::endl;
+        for (int i = 0; i < k; i++)
+        {
+            std::cout << "Cluster " << i << " sum: " << sums[i] << std::endl;
+            totalSum += sums[i];
+        }
+
+        std::cout << "Total sum: " << totalSum << std::endl;
+    }
+
+    // The centroids are final now: one more pass measures the clustering
+    std::vector<double> sums(k, 0.0);
+    std::vector<size_t> cardinalities(k, 0);
+    std::vector<std::unordered_map<std::string, int>> occurances(k);
+    reader.rewind();
+    while ((count = reader.read(batchSize, batch, attributes)) != 0)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            double distance = 0;
+            size_t c = kmeans.nearest(batch.data() + i * reader.dimensions(), distance);
+            sums[c] += distance;
+            cardinalities[c]++;
+            occurances[c][attributes[i]]++;
+        }
+    }
+
+    double totalSum = 0;
+    for (int i = 0; i < k; i++)
+    {
+        totalSum += sums[i];
+    }
+
+    std::cout << std::endl;
+    std::cout << "FINALL RESULTS" << std::endl;
+    std::cout << "Passes = " << passes << ", batches = " << batches << " of " << batchSize << " points" << std::endl;
+    std::cout << "SSE = " << totalSum << std::endl;
+    for (int i = 0; i < k; i++)
+    {
+        std::cout << "Cluster " << i << ": " << std::endl;
+        std::cout << "Cardinality = " << cardinalities[i] << std::endl;
+        std::cout << "Entropy = " << entropy(occurances[i], cardinalities[i]) << std::endl;
+    }
+};
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include "Sweep.h"
+
+double sampledSilhouette(const std::vector<Point> &points, const std::vector<int> &labels, const std::vector<size_t> &sample)
+{
+    const int k = *std::max_element(labels.begin(), labels.end()) + 1;
+    std::vector<double> sums(k);
+    std::vector<size_t> counts(k);
+    double total = 0;
+    for (size_t i : sample)
+    {
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (size_t j : sample)
+        {
+            if (i != j)
+            {
+                sums[labels[j]] += std::sqrt(distanceSquare(points[i], points[j]));
+                counts[labels[j]]++;
+            }
+        }
+
+        const int own = labels[i];
+        if (counts[own] == 0)
+        {
+            continue;
+        }
+
+        // Mean distance to the own cluster against the nearest other one
+        double a = sums[own] / counts[own];
+        double b = INFINITY;
+        for (int c = 0; c < k; c++)
+        {
+            if (c != own && counts[c] != 0)
+            {
+                b = std::min(b, sums[c] / counts[c]);
+            }
+        }
+
+        if (b != INFINITY && std::max(a, b) > 0)
+        {
+            total += (b - a) / std::max(a, b);
+        }
+    }
+
+    return sample.empty() ? 0 : total / sample.size();
+};
+
+void runSweep(const std::vector<Point> &points, int kMin, int kMax, size_t restarts, Variant variant, bool plusPlus, ThreadPool &pool, Random &random)
+{
+    // The same sample for every K, so their silhouettes compare
+    std::vector<size_t> sample(points.size());
+    std::iota(sample.begin(), sample.end(), 0);
+    const size_t sampleSize = std::min<size_t>(SILHOUETTE_SAMPLE, points.size());
+    for (size_t i = 0; i < sampleSize; i++)
+    {
+        std::swap(sample[i], sample[i + random.below(points.size() - i)]);
+    }
+
+    sample.resize(sampleSize);
+
+    std::vector<SweepResult> results(kMax - kMin + 1);
+    for (int k = kMin; k <= kMax; k++)
+    {
+        pool.submit([&, k]() {
+            SweepResult &result = results[k - kMin];
+            KMeansResult run{};
+            for (size_t r = 0; r < restarts; r++)
+            {
+                Random generator = random.stream(k * restarts + r);
+                std::vector<int> labels{};
+                if (plusPlus)
+                {
+                    initializeClustersPlusPlus(k, points, labels, generator);
+                }
+                else
+                {
+                    initializeClustersRandomly(k, points, labels, generator);
+                }
+
+                KMeansResult attempt = runKMeans(points, k, variant, labels, nullptr, nullptr);
+                result.Seconds += attempt.Seconds;
+                if (r == 0 || attempt.SSE < run.SSE)
+                {
+                    run = std::move(attempt);
+                }
+            }
+
+            result.K = k;
+            result.SSE = run.SSE;
+            result.Iterations = run.Iterations;
+            std::vector<double> entropies = clusterEntropies(points, run.Labels, k);
+            for (int c = 0; c < k; c++)
+            {
+                result.Entropy += entropies[c] * run.Totals.Counts[c] / points.size();
+            }
+
+            result.Silhouette = sampledSilhouette(points, run.Labels, sample);
+        });
+    }
+
+    pool.wait();
+
+    std::cout << "SWEEP K = " << kMin << ".." << kMax << ", restarts = " << restarts << ", silhouette sample = " << sampleSize << std::endl;
+    const double drop = results.front().SSE - results.back().SSE;
+    size_t elbow = 0;
+    size_t best = 0;
+    double farthest = -INFINITY;
+    for (size_t r = 0; r < results.size(); r++)
+    {
+        const SweepResult &result = results[r];
+        std::cout << "K = " << result.K << ": SSE = " << result.SSE << ", entropy = " << result.Entropy
+                  << ", silhouette = " << result.Silhouette << ", iterations = " << result.Iterations
+                  << ", seconds = " << result.Seconds << std::endl;
+        best = result.Silhouette > results[best].Silhouette ? r : best;
+        if (r > 0 && r + 1 < results.size() && drop > 0)
+        {
+            double below = 1.0 - (double)r / (results.size() - 1) - (result.SSE - results.back().SSE) / drop;
+            if (below > farthest)
+            {
+                farthest = below;
+                elbow = r;
+            }
+        }
+    }
+
+    if (farthest > -INFINITY)
+    {
+        std::cout << "Elbow K = " << results[elbow].K << std::endl;
+    }
+
+    std::cout << "Best silhouette K = " << results[best].K << std::endl;
+};
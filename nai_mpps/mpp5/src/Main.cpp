@@ -11,6 +11,8 @@
 #include <cmath>
 #include <format>
 
+#include "ConfusionMatrix.h"
+
 void normalize(std::vector<float> &v)
 {
     double length = 0;
@@ -52,19 +54,6 @@ float normal_distribution(float mean, float std_dev, float x)
     return nom / denom;
 };
 
-struct ConfusionMatrix
-{
-    int True_positive = 0;
-    int False_positive = 0;
-    int True_negative = 0;
-    int False_negative = 0;
-
-    float accuracy() const;
-    float precision() const;
-    float recall() const;
-    float f1() const;
-};
-
 class DecisionTable
 {
 private:
@@ -101,51 +90,10 @@ private:
 
 public:
     Classifier(DecisionTable &trainData, DecisionTable &testData) : m_trainData(trainData), m_testData(testData){};
-    void printPerfMeasurments(std::unordered_map<int, ConfusionMatrix> &result);
+    void printPerfMeasurments();
     int classify(std::vector<float> &new_case);
 };
 
-float ConfusionMatrix::accuracy() const
-{
-    int denom = True_positive + True_negative + False_positive + False_negative;
-    return (float)(True_positive + True_negative) / denom;
-};
-
-float ConfusionMatrix::precision() const
-{
-    int denom = True_positive + False_positive;
-    if (denom == 0)
-    {
-        return std::nanf("");
-    }
-
-    return (float)True_positive / denom;
-};
-
-float ConfusionMatrix::recall() const
-{
-    int denom = True_positive + False_negative;
-    if (denom == 0)
-    {
-        return std::nanf("");
-    }
-
-    return (float)True_positive / denom;
-};
-
-float ConfusionMatrix::f1() const
-{
-    float p = precision();
-    float r = recall();
-    float denom = p + r;
-    if (denom == 0)
-    {
-        return std::nanf("");
-    }
-
-    return 2.0f * p * r / (p + r);
-};
-
 void DecisionTable::computeStatistics()
 {
     for (auto &&it : m_decisionMap)
@@ -191,53 +139,43 @@ void DecisionTable::computeStatistics()
     }
 };
 
-void Classifier::printPerfMeasurments(std::unordered_map<int, ConfusionMatrix> &result)
+void Classifier::printPerfMeasurments()
 {
-    int correct = 0;
+    // classify() reads the training statistics through operator[], so it stays on one thread.
+    // A row it cannot classify (-1) is a false negative of its true class.
+    ConfusionMatrix result(m_trainData.class_attribute_means.size());
     for (size_t i = 0; i < m_testData.rows(); i++)
     {
         int answer = classify(m_testData.matrix()[i]);
-        if (answer == m_testData.decision()[i])
+        if (answer < 0)
         {
-            ++correct;
-            for (auto &&it : result)
-            {
-                if (it.first == m_testData.decision()[i])
-                {
-                    it.second.True_positive++;
-                    continue;
-                }
-
-                it.second.True_negative++;
-            }
+            result.addUnpredicted(m_testData.decision()[i]);
+            continue;
         }
 
-        else
-        {
-            result[m_testData.decision()[i]].False_negative++;
-            result[answer].False_positive++;
-            for (auto &&it : result)
-            {
-                if (it.first == answer || it.first == m_testData.decision()[i])
-                    continue;
-                it.second.True_negative++;
-            }
-        }
+        result.add(m_testData.decision()[i], answer);
     }
 
-    for (auto &&it : result)
+    for (size_t c = 0; c < result.classes(); c++)
     {
-        std::cout << "Flower: " << m_trainData.toDecisionString(it.first) << std::endl;
-        std::cout << "TP: " << it.second.True_positive << " FP : " << it.second.False_positive << std::endl;
-        std::cout << "FN: " << it.second.False_negative << " TN : " << it.second.True_negative << std::endl;
-        std::printf("Accuracy: %.2f%%\n", it.second.accuracy() * 100);
-        std::printf("Precision:%.2f%%\n", it.second.precision() * 100);
-        std::printf("Recall: %.2f%%\n", it.second.recall() * 100);
-        std::printf("F1: %.2f%%\n", it.second.f1() * 100);
+        std::cout << "Flower: " << m_trainData.toDecisionString(c) << std::endl;
+        std::cout << "TP: " << result.truePositives(c) << " FP : " << result.falsePositives(c) << std::endl;
+        std::cout << "FN: " << result.falseNegatives(c) << " TN : " << result.trueNegatives(c) << std::endl;
+        std::printf("Accuracy: %.2f%%\n", result.accuracy(c) * 100);
+        std::printf("Precision:%.2f%%\n", result.precision(c) * 100);
+        std::printf("Recall: %.2f%%\n", result.recall(c) * 100);
+        std::printf("F1: %.2f%%\n", result.f1(c) * 100);
         std::cout << std::endl;
     }
 
-    std::printf("Accuracy: %.2f%%\n", (float)correct / m_testData.rows() * 100);
+    std::printf("Macro precision: %.2f%% recall: %.2f%% F1: %.2f%%\n", result.macroPrecision() * 100, result.macroRecall() * 100, result.macroF1() * 100);
+    std::printf("Micro precision: %.2f%% recall: %.2f%% F1: %.2f%%\n", result.microPrecision() * 100, result.microRecall() * 100, result.microF1() * 100);
+    if (result.unpredicted() > 0)
+    {
+        std::cout << "Unclassified: " << result.unpredicted() << std::endl;
+    }
+
+    std::printf("Accuracy: %.2f%%\n", result.accuracy() * 100);
 };
 
 int Classifier::classify(std::vector<float> &new_case)
@@ -400,13 +338,7 @@ int main(int argc, char const *argv[])
     train_table.computeStatistics();
     Classifier classifier(train_table, test_table);
 
-    std::unordered_map<int, ConfusionMatrix> confusion_matrices{};
-    for (auto &&it : decision_map)
-    {
-        confusion_matrices.insert({it.second, {}});
-    }
-
-    classifier.printPerfMeasurments(confusion_matrices);
+    classifier.printPerfMeasurments();
 
     char c;
     std::string value;
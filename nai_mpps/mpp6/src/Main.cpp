@@ -7,6 +7,8 @@
 #include <regex>
 #include <vector>
 
+#include "Random.h"
+
 #define INPUT_FILE "knapsack.txt"
 
 struct Dataset
@@ -162,7 +164,18 @@ void print_results(uint32_t combination, const Dataset &dataset, float delta_tim
 
 int main(int argc, char const *argv[])
 {
-    srand(time(NULL));
+    // "--seed N" reproduces a previous run
+    uint64_t seed = (uint64_t)time(NULL);
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--seed")
+        {
+            seed = std::stoull(argv[i + 1]);
+        }
+    }
+
+    std::cout << "Seed: " << seed << std::endl;
+    Random random(seed);
 
     __int64 counts_per_sec;
     QueryPerformanceFrequency((LARGE_INTEGER *)&counts_per_sec);
@@ -174,7 +187,7 @@ int main(int argc, char const *argv[])
     Knapsack knapsack{};
     parse(INPUT_FILE, knapsack);
 
-    Dataset chosen_dataset = knapsack.Datasets[std::rand() % knapsack.Datasets.size()];
+    Dataset chosen_dataset = knapsack.Datasets[random.below(knapsack.Datasets.size())];
     std::cout << "Randomly chosen dataset: "
               << "\"" << chosen_dataset.Name << "\"" << std::endl;
 